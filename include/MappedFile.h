@@ -0,0 +1,36 @@
+/*
+ * xSF - Memory-mapped file
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Read-only memory mapping of a file on disk.
+ */
+
+#pragma once
+
+#include "VirtualFile.h"
+#include <string>
+
+class MappedFile : public VirtualFile {
+  const uint8_t *data;
+  size_t size;
+#ifdef _WIN32
+  void *fileHandle, *mappingHandle;
+
+  void Open(const std::wstring &filename);
+#endif
+
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+public:
+  MappedFile(const std::string &filename);
+#ifdef _WIN32
+  MappedFile(const std::wstring &filename);
+#endif
+  ~MappedFile();
+
+  ByteView GetView() const override {
+    return ByteView(this->data, this->size);
+  }
+};
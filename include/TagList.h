@@ -1,7 +1,7 @@
 /*
  * xSF Tag List
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-08
+ * Last modification on 2026-10-19
  *
  * Storage of tags from PSF-style files, specifications found at
  * http://wiki.neillcorlett.com/PSFTagFormat
@@ -9,29 +9,89 @@
 
 #pragma once
 
-#include "eqstr.h"
-#include "ltstr.h"
-#include <map>
+#include <cstdint>
+#include <string>
+#include <string_view>
 #include <vector>
 
+// The name of a tag along with a case-insensitive hash of it. Tag names are
+// compared case-insensitively, and the hash lets most mismatches be rejected
+// without comparing the names at all. A TagKey does not own its name, so it
+// should only be used for the duration of a lookup, or be made from a string
+// that lives at least as long as it does (such as a string literal).
+class TagKey {
+  std::string_view name;
+  uint32_t hash;
+
+  static constexpr char ToUpper(char c) {
+    return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+  }
+
+public:
+  // FNV-1a over the upper-cased name
+  static constexpr uint32_t Hash(std::string_view str) {
+    uint32_t h = 2166136261u;
+    for (char c : str) {
+      h ^= static_cast<uint8_t>(TagKey::ToUpper(c));
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  static constexpr bool Equals(std::string_view x, std::string_view y) {
+    if (x.length() != y.length())
+      return false;
+    for (size_t i = 0, len = x.length(); i < len; ++i)
+      if (TagKey::ToUpper(x[i]) != TagKey::ToUpper(y[i]))
+        return false;
+    return true;
+  }
+
+  constexpr TagKey(const char *n) : name(n), hash(TagKey::Hash(name)) {}
+  constexpr TagKey(std::string_view n) : name(n), hash(TagKey::Hash(name)) {}
+  TagKey(const std::string &n) : name(n), hash(TagKey::Hash(name)) {}
+  constexpr TagKey(std::string_view n, uint32_t h) : name(n), hash(h) {}
+
+  constexpr std::string_view GetName() const { return this->name; }
+  constexpr uint32_t GetHash() const { return this->hash; }
+};
+
+// Tags that are looked up on every load or metadata scan, their hashes are
+// computed at compile time.
+namespace WellKnownTags {
+constexpr TagKey Lib("_lib"), Frames("_frames"), Length("length"),
+    Fade("fade"), Volume("volume"),
+    ReplayGainAlbumGain("replaygain_album_gain"),
+    ReplayGainAlbumPeak("replaygain_album_peak"),
+    ReplayGainTrackGain("replaygain_track_gain"),
+    ReplayGainTrackPeak("replaygain_track_peak");
+} // namespace WellKnownTags
+
+// The tags are kept in a single vector in the order they were added. Files
+// rarely have more than a couple dozen tags, so a linear scan over the hashes
+// is faster than any tree or node-based hash table.
 class TagList {
 public:
-  typedef std::map<std::string, std::string, lt_str> Tags;
   typedef std::vector<std::string> TagsList;
 
 private:
-  static eq_str eqstr;
+  struct Tag {
+    uint32_t hash;
+    std::string name, value;
+  };
+
+  std::vector<Tag> tags;
 
-  Tags tags;
-  TagsList tagsOrder;
+  const Tag *FindTag(const TagKey &name) const;
 
 public:
-  TagList() : tags(), tagsOrder() {}
-  const TagsList &GetKeys() const;
+  TagList() : tags() {}
+  TagsList GetKeys() const;
   TagsList GetTags() const;
-  bool Exists(const std::string &name) const;
-  std::string operator[](const std::string &name) const;
-  std::string &operator[](const std::string &name);
-  void Remove(const std::string &name);
+  bool Exists(const TagKey &name) const;
+  const std::string *Find(const TagKey &name) const;
+  std::string_view operator[](const TagKey &name) const;
+  std::string &operator[](const TagKey &name);
+  void Remove(const TagKey &name);
   void Clear();
 };
@@ -0,0 +1,49 @@
+/*
+ * xSF - Title formatting
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * A title format string, compiled once into a list of operations so it can be
+ * applied to the tags of any number of files without being parsed again.
+ *
+ * %tag% is replaced by the value of the tag, or ??? if the tag is empty or
+ * missing. [...] is an optional block, which is only output if at least one
+ * tag directly inside of it had a value. Optional blocks can be nested up to 9
+ * levels deep.
+ */
+
+#pragma once
+
+#include "TagList.h"
+#include <string>
+#include <vector>
+
+class TitleFormat {
+  enum OpCode { OP_LITERAL, OP_TAG, OP_BLOCK_START, OP_BLOCK_END };
+
+  // For OP_LITERAL, start and length are a range within literals, for OP_TAG,
+  // start is an index into tagNames and tagHashes.
+  struct Op {
+    OpCode code;
+    size_t start, length;
+  };
+
+  static const unsigned MaxBlockLevel = 9;
+
+  std::string literals;
+  std::vector<std::string> tagNames;
+  std::vector<uint32_t> tagHashes;
+  std::vector<Op> ops;
+
+  void AddLiteral(char c);
+  void AddTag(const std::string &name);
+  void Compile(const std::string &format, size_t start, size_t end,
+               unsigned level);
+  template <typename Output>
+  void Evaluate(const TagList &tags, Output &output) const;
+
+public:
+  TitleFormat() : literals(), tagNames(), tagHashes(), ops() {}
+  TitleFormat(const std::string &format);
+  std::string Format(const TagList &tags) const;
+};
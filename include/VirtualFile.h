@@ -0,0 +1,73 @@
+/*
+ * xSF - Virtual files
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * A read-only file that is either a file on disk or a member of a zip archive,
+ * along with a bounds-checked view into any contiguous block of bytes.
+ *
+ * A member of an archive is named by treating the archive as if it were a
+ * directory, such as C:\Music\Set.zip\01.minigsf, which means that _lib
+ * tags relative to a file within an archive resolve to other members of the
+ * same archive without any special handling.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A non-owning, read-only view of a contiguous block of bytes.  The view is
+// only valid as long as whatever owns the bytes is still alive and unmodified.
+class ByteView {
+  const uint8_t *data_;
+  size_t size_;
+
+public:
+  ByteView() : data_(nullptr), size_(0) {}
+  ByteView(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+  ByteView(const std::vector<uint8_t> &vec)
+      : data_(vec.empty() ? nullptr : &vec[0]), size_(vec.size()) {}
+
+  const uint8_t *data() const { return this->data_; }
+  size_t size() const { return this->size_; }
+  bool empty() const { return !this->size_; }
+  const uint8_t *begin() const { return this->data_; }
+  const uint8_t *end() const { return this->data_ + this->size_; }
+  const uint8_t &operator[](size_t pos) const { return this->at(pos); }
+  const uint8_t &at(size_t pos) const {
+    if (pos >= this->size_)
+      throw std::out_of_range("ByteView position out of range.");
+    return this->data_[pos];
+  }
+  // Gets a view of part of this view, throwing if it would go past the end.
+  ByteView Subview(size_t offset, size_t length) const {
+    if (offset > this->size_ || length > this->size_ - offset)
+      throw std::out_of_range("ByteView subview out of range.");
+    return ByteView(this->data_ + offset, length);
+  }
+  std::vector<uint8_t> ToVector() const {
+    return std::vector<uint8_t>(this->begin(), this->end());
+  }
+};
+
+class VirtualFile {
+public:
+  virtual ~VirtualFile() {}
+
+  virtual ByteView GetView() const = 0;
+  ByteView GetView(size_t offset, size_t length) const {
+    return this->GetView().Subview(offset, length);
+  }
+  size_t GetSize() const { return this->GetView().size(); }
+
+  // Opens either the file on disk or the member of an archive, throwing a
+  // std::logic_error if neither exists.
+  static std::shared_ptr<const VirtualFile> Open(const std::string &path);
+  // True if the path names a member of an archive rather than a file on disk.
+  static bool IsArchiveMember(const std::string &path);
+};
@@ -1,7 +1,7 @@
 /*
  * xSF - Core configuration handler
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-10-05
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  */
@@ -57,6 +57,7 @@ protected:
   PeakType peakType;
   unsigned sampleRate;
   std::string titleFormat;
+  TitleFormat compiledTitleFormat;
   DialogTemplate configDialog, configDialogProperty, infoDialog;
   std::vector<unsigned> supportedSampleRates;
   std::unique_ptr<XSFConfigIO> configIO;
@@ -119,4 +120,5 @@ public:
   VolumeType GetVolumeType() const;
   PeakType GetPeakType() const;
   const std::string &GetTitleFormat() const;
+  const TitleFormat &GetCompiledTitleFormat() const;
 };
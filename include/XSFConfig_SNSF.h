@@ -1,7 +1,7 @@
 /*
  * xSF - SNSF configuration
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-24
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  *
@@ -18,12 +18,12 @@
 
 class XSFConfig_SNSF : public XSFConfig {
 protected:
-  static bool /*initSixteenBitSound, */ initReverseStereo;
-  static unsigned initResampler;
+  static bool /*initSixteenBitSound, */ initReverseStereo, initAudioOnly;
+  static unsigned initResampler, initResamplerPhases;
   static std::string initMutes;
 
   friend class XSFConfig;
-  bool /*sixteenBitSound, */ reverseStereo;
+  bool /*sixteenBitSound, */ reverseStereo, audioOnly;
   std::bitset<8> mutes;
 
   XSFConfig_SNSF();
@@ -37,7 +37,7 @@ protected:
   void CopySpecificConfigToMemory(XSFPlayer *xSFPlayer, bool preLoad);
 
 public:
-  unsigned resampler;
+  unsigned resampler, resamplerPhases;
 
   void About(HWND parent);
 };
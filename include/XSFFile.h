@@ -1,16 +1,19 @@
 /*
  * xSF - File structure
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-24
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  */
 
 #pragma once
 
+#include "VirtualFile.h"
 #include "TagList.h"
+#include "TitleFormat.h"
 #include "convert.h"
 #include <cstdint>
+#include <memory>
 
 enum VolumeType {
   VOLUMETYPE_NONE,
@@ -29,6 +32,16 @@ class XSFFile {
 protected:
   uint8_t xSFType;
   bool hasFile;
+  // A copy of the header as it was when the file was read, the CRC within it
+  // is used to tell if the file has been changed since.
+  uint8_t header[16];
+  // The file (either mapped from disk or a member of a zip archive) is kept for
+  // as long as any copy of this object exists, and the views point directly
+  // into it. The vectors for the raw data and reserved section are only filled
+  // once they need to be modified (or the mapping is released), after which
+  // they take the place of the views.
+  std::shared_ptr<const VirtualFile> virtualFile;
+  ByteView rawDataView, reservedSectionView;
   std::vector<uint8_t> rawData, reservedSection, programSection;
   TagList tags;
   std::string fileName;
@@ -38,11 +51,13 @@ protected:
   void ReadXSF(const std::wstring &filename, uint32_t programSizeOffset,
                uint32_t programHeaderSize, bool readTagsOnly = false);
 #endif
-  void ReadXSF(std::ifstream &xSF, uint32_t programSizeOffset,
-               uint32_t programHeaderSize, bool readTagsOnly = false);
-  std::string FormattedTitleOptionalBlock(const std::string &block,
-                                          bool &hadReplacement,
-                                          unsigned level) const;
+  void ReadXSF(uint32_t programSizeOffset, uint32_t programHeaderSize,
+               bool readTagsOnly);
+  ByteView GetRawData() const;
+  void ReleaseMapping();
+  std::string GetTagBlock() const;
+  bool UpdateTagsInPlace(const std::string &tagBlock);
+  void RewriteFile(const std::string &tagBlock);
 
 public:
   XSFFile();
@@ -58,27 +73,27 @@ public:
   void Clear();
   bool HasFile() const;
   std::vector<uint8_t> &GetReservedSection();
-  std::vector<uint8_t> GetReservedSection() const;
+  ByteView GetReservedSection() const;
   std::vector<uint8_t> &GetProgramSection();
-  std::vector<uint8_t> GetProgramSection() const;
+  const std::vector<uint8_t> &GetProgramSection() const;
   const TagList &GetAllTags() const;
   void SetAllTags(const TagList &newTags);
   void SetTag(const std::string &name, const std::string &value);
   void SetTag(const std::string &name, const std::wstring &value);
-  bool GetTagExists(const std::string &name) const;
-  std::string GetTagValue(const std::string &name) const;
+  bool GetTagExists(const TagKey &name) const;
+  std::string_view GetTagValue(const TagKey &name) const;
   template <typename T>
-  T GetTagValue(const std::string &name, const T &defaultValue) const {
-    return this->GetTagExists(name)
-               ? convertTo<T>(this->GetTagValue(name), false)
-               : defaultValue;
+  T GetTagValue(const TagKey &name, const T &defaultValue) const {
+    auto value = this->tags.Find(name);
+    return value ? convertTo<T>(*value, false) : defaultValue;
   }
   unsigned long GetLengthMS(unsigned long defaultLength) const;
   unsigned long GetFadeMS(unsigned long defaultFade) const;
   double GetVolume(VolumeType preferredVolumeType,
                    PeakType preferredPeakType) const;
   std::string GetFormattedTitle(const std::string &format) const;
+  std::string GetFormattedTitle(const TitleFormat &format) const;
   std::string GetFilename() const;
   std::string GetFilenameWithoutPath() const;
-  void SaveFile() const;
+  void SaveFile();
 };
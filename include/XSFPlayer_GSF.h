@@ -0,0 +1,42 @@
+/*
+ * xSF - GSF Player
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Based on a modified viogsf v0.08
+ *
+ * Partially based on the vio*sf framework
+ *
+ * Utilizes a modified VBA-M, SVN revision 1102, for playback
+ * http://vba-m.com/
+ *
+ * Songs from games using Nintendo's MusicPlayer2000 sound engine can instead
+ * be played by a high-level emulation of the engine
+ */
+
+#pragma once
+
+#include "MP2KPlayer/Player.h"
+#include "XSFPlayer.h"
+#include <bitset>
+
+class XSFPlayer_GSF : public XSFPlayer {
+  Player mp2kPlayer;
+  bool useMP2KHighLevelEmulation, playingMP2K;
+
+  bool StartMP2K(int romSize);
+
+public:
+  XSFPlayer_GSF(const std::string &filename);
+#ifdef _WIN32
+  XSFPlayer_GSF(const std::wstring &filename);
+#endif
+  ~XSFPlayer_GSF() { this->Terminate(); }
+  bool Load();
+  void GenerateSamples(std::vector<uint8_t> &buf, unsigned offset,
+                       unsigned samples);
+  void Terminate();
+
+  void SetMP2KHighLevelEmulation(bool enabled);
+  void SetMutes(const std::bitset<6> &newMutes);
+};
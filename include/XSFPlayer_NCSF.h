@@ -26,7 +26,7 @@ class XSFPlayer_NCSF : public XSFPlayer {
   std::bitset<16> mutes;
 
   void MapNCSFSection(const std::vector<uint8_t> &section);
-  bool MapNCSF(XSFFile *xSFToLoad);
+  bool MapNCSF(const XSFFile *xSFToLoad);
   bool RecursiveLoadNCSF(XSFFile *xSFToLoad, int level);
   bool LoadNCSF();
 
@@ -0,0 +1,47 @@
+/*
+ * xSF - Zip archives
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Read-only access to the members of a zip archive, specifications found at
+ * https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+ *
+ * Only stored and deflated members are supported, which covers the archives
+ * that xSF sets are distributed in.
+ */
+
+#pragma once
+
+#include "MappedFile.h"
+#include "ltstr.h"
+#include <map>
+#include <memory>
+#include <string>
+
+// Archives are always owned by a shared_ptr, since the members opened from one
+// hold on to it.
+class ZipArchive : public std::enable_shared_from_this<ZipArchive> {
+  struct Entry {
+    uint16_t method;
+    uint32_t crc, compressedSize, uncompressedSize, localHeaderOffset;
+  };
+
+  std::shared_ptr<const MappedFile> file;
+  std::string fileName;
+  // Member names are matched case-insensitively, the same as file names on
+  // Windows, since _lib tags do not always match the case of the file.
+  std::map<std::string, Entry, lt_str> entries;
+
+  void ReadCentralDirectory();
+
+  ZipArchive(const ZipArchive &);
+  ZipArchive &operator=(const ZipArchive &);
+
+public:
+  ZipArchive(const std::string &filename);
+
+  std::shared_ptr<const VirtualFile> OpenMember(const std::string &name) const;
+
+  // Uses forward slashes and removes any . and .. from the name.
+  static std::string NormalizeMemberName(const std::string &name);
+};
@@ -144,12 +144,12 @@ bool XSFPlayer_2SF::Map2SF(XSFFile *xSFToLoad)
 
 bool XSFPlayer_2SF::RecursiveLoad2SF(XSFFile *xSFToLoad, int level)
 {
-	if (level <= 10 && xSFToLoad->GetTagExists("_lib"))
+	if (level <= 10 && xSFToLoad->GetTagExists(WellKnownTags::Lib))
 	{
 #ifdef _WIN32
-		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue("_lib")), 4, 8));
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(WellKnownTags::Lib))), 4, 8));
 #else
-		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue("_lib"), 4, 8));
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(WellKnownTags::Lib)), 4, 8));
 #endif
 		if (!this->RecursiveLoad2SF(libxSF.get(), level + 1))
 			return false;
@@ -168,9 +168,9 @@ bool XSFPlayer_2SF::RecursiveLoad2SF(XSFFile *xSFToLoad, int level)
 		{
 			found = true;
 #ifdef _WIN32
-			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue(libTag)), 4, 8));
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(libTag))), 4, 8));
 #else
-			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue(libTag), 4, 8));
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(libTag)), 4, 8));
 #endif
 			if (!this->RecursiveLoad2SF(libxSF.get(), level + 1))
 				return false;
@@ -201,7 +201,7 @@ XSFPlayer_2SF::XSFPlayer_2SF(const std::wstring &filename) : XSFPlayer()
 
 bool XSFPlayer_2SF::Load()
 {
-	int frames = this->xSF->GetTagValue("_frames", -1);
+	int frames = this->xSF->GetTagValue(WellKnownTags::Frames, -1);
 	sndifwork.sync_type = this->xSF->GetTagValue("_2sf_sync_type", 0);
 
 	sndifwork.xfs_load = false;
@@ -399,16 +399,83 @@ TEMPLATE static uint32_t fastCopy()
 	return 1;
 }
 
-TEMPLATE static uint32_t LZ77UnCompVram()
+// The decompression functions go a byte at a time, so rather than always going through the full memory handling for each byte, they
+// are written over one of these.  BIOSMemory is the full memory handling.
+TEMPLATE struct BIOSMemory
 {
-	uint32_t source = cpu->R[0];
-	uint32_t dest = cpu->R[1];
-	uint32_t header = _MMU_read32<PROCNUM>(source);
-	source += 4;
+	uint8_t ReadSource(uint32_t address) const { return _MMU_read08<PROCNUM>(address); }
+	uint8_t ReadDest(uint32_t address) const { return _MMU_read08<PROCNUM>(address); }
+	void Write8(uint32_t address, uint8_t val) const { _MMU_write08<PROCNUM>(address, val); }
+	void Write16(uint32_t address, uint16_t val) const { _MMU_write16<PROCNUM>(address, val); }
+};
 
-	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
-		return 0;
+// BIOSDirectMemory goes straight to main memory, when the destination lies in it throughout, and for the source for as far as that lies
+// in it.  On the ARM9, neither can run into the DTCM.  Reads that fall outside of that, such as a malformed stream running off the end of
+// the source or LZ77 reading back from before the start of the destination, still go through the full memory handling.
+TEMPLATE struct BIOSDirectMemory
+{
+	uint32_t sourceStart, sourceSize, destStart, destSize;
+
+	bool Setup(uint32_t source, uint32_t dest, uint32_t len)
+	{
+		// Huffman writes a word's worth at a time, so up to 3 bytes past the length
+		this->destStart = dest;
+		this->destSize = len + 4;
+		uint32_t destEnd = dest + this->destSize;
+		if ((dest & 0x0F000000) != 0x02000000 || (destEnd >> 24) != (dest >> 24))
+			return false;
+		if (PROCNUM == ARMCPU_ARM9 && (dest - MMU.DTCMRegion < 0x4000 || MMU.DTCMRegion - dest < this->destSize))
+			return false;
+
+		this->sourceStart = source;
+		this->sourceSize = 0;
+		if ((source & 0x0F000000) == 0x02000000)
+		{
+			this->sourceSize = 0x1000000 - (source & 0xFFFFFF);
+			if (PROCNUM == ARMCPU_ARM9)
+			{
+				if (source - MMU.DTCMRegion < 0x4000)
+					this->sourceSize = 0;
+				else if (MMU.DTCMRegion - source < this->sourceSize)
+					this->sourceSize = MMU.DTCMRegion - source;
+			}
+		}
+		return true;
+	}
 
+	uint8_t ReadSource(uint32_t address) const
+	{
+		if (address - this->sourceStart < this->sourceSize)
+			return T1ReadByte(MMU.MAIN_MEM, address & _MMU_MAIN_MEM_MASK);
+		return _MMU_read08<PROCNUM>(address);
+	}
+
+	uint8_t ReadDest(uint32_t address) const
+	{
+		if (address - this->destStart < this->destSize)
+			return T1ReadByte(MMU.MAIN_MEM, address & _MMU_MAIN_MEM_MASK);
+		return _MMU_read08<PROCNUM>(address);
+	}
+
+	void Write8(uint32_t address, uint8_t val) const
+	{
+#ifdef HAVE_JIT
+		JIT_COMPILED_FUNC_KNOWNBANK(address, MAIN_MEM, _MMU_MAIN_MEM_MASK, 0) = 0;
+#endif
+		T1WriteByte(MMU.MAIN_MEM, address & _MMU_MAIN_MEM_MASK, val);
+	}
+
+	void Write16(uint32_t address, uint16_t val) const
+	{
+#ifdef HAVE_JIT
+		JIT_COMPILED_FUNC_KNOWNBANK(address, MAIN_MEM, _MMU_MAIN_MEM_MASK16, 0) = 0;
+#endif
+		T1WriteWord(MMU.MAIN_MEM, address & _MMU_MAIN_MEM_MASK16, val);
+	}
+};
+
+template<typename Memory> static uint32_t LZ77UnCompVramWith(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int byteCount = 0;
 	int byteShift = 0;
 	uint32_t writeValue = 0;
@@ -417,7 +484,7 @@ TEMPLATE static uint32_t LZ77UnCompVram()
 
 	while (len > 0)
 	{
-		uint8_t d = _MMU_read08<PROCNUM>(source++);
+		uint8_t d = memory.ReadSource(source++);
 
 		int i1, i2;
 		if (d)
@@ -426,20 +493,20 @@ TEMPLATE static uint32_t LZ77UnCompVram()
 			{
 				if (d & 0x80)
 				{
-					uint16_t data = _MMU_read08<PROCNUM>(source++) << 8;
-					data |= _MMU_read08<PROCNUM>(source++);
+					uint16_t data = memory.ReadSource(source++) << 8;
+					data |= memory.ReadSource(source++);
 					int length = (data >> 12) + 3;
 					int offset = data & 0x0FFF;
 					uint32_t windowOffset = dest + byteCount - offset - 1;
 					for (i2 = 0; i2 < length; ++i2)
 					{
-						writeValue |= _MMU_read08<PROCNUM>(windowOffset++) << byteShift;
+						writeValue |= memory.ReadDest(windowOffset++) << byteShift;
 						byteShift += 8;
 						++byteCount;
 
 						if (byteCount == 2)
 						{
-							_MMU_write16<PROCNUM>(dest, writeValue & 0xFFFF);
+							memory.Write16(dest, writeValue & 0xFFFF);
 							dest += 2;
 							byteCount = 0;
 							byteShift = 0;
@@ -452,12 +519,12 @@ TEMPLATE static uint32_t LZ77UnCompVram()
 				}
 				else
 				{
-					writeValue |= _MMU_read08<PROCNUM>(source++) << byteShift;
+					writeValue |= memory.ReadSource(source++) << byteShift;
 					byteShift += 8;
 					++byteCount;
 					if (byteCount == 2)
 					{
-						_MMU_write16<PROCNUM>(dest, writeValue & 0xFFFF);
+						memory.Write16(dest, writeValue & 0xFFFF);
 						dest += 2;
 						byteCount = 0;
 						byteShift = 0;
@@ -474,12 +541,12 @@ TEMPLATE static uint32_t LZ77UnCompVram()
 		{
 			for (i1 = 0; i1 < 8; ++i1)
 			{
-				writeValue |= _MMU_read08<PROCNUM>(source++) << byteShift;
+				writeValue |= memory.ReadSource(source++) << byteShift;
 				byteShift += 8;
 				++byteCount;
 				if (byteCount == 2)
 				{
-					_MMU_write16<PROCNUM>(dest, writeValue & 0xFFFF);
+					memory.Write16(dest, writeValue & 0xFFFF);
 					dest += 2;
 					byteShift = 0;
 					byteCount = 0;
@@ -494,7 +561,7 @@ TEMPLATE static uint32_t LZ77UnCompVram()
 	return 1;
 }
 
-TEMPLATE static uint32_t LZ77UnCompWram()
+TEMPLATE static uint32_t LZ77UnCompVram()
 {
 	uint32_t source = cpu->R[0];
 	uint32_t dest = cpu->R[1];
@@ -504,11 +571,19 @@ TEMPLATE static uint32_t LZ77UnCompWram()
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return 0;
 
+	BIOSDirectMemory<PROCNUM> direct;
+	if (direct.Setup(source, dest, header >> 8))
+		return LZ77UnCompVramWith(direct, source, dest, header);
+	return LZ77UnCompVramWith(BIOSMemory<PROCNUM>(), source, dest, header);
+}
+
+template<typename Memory> static uint32_t LZ77UnCompWramWith(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int len = header >> 8;
 
 	while (len > 0)
 	{
-		uint8_t d = _MMU_read08<PROCNUM>(source++);
+		uint8_t d = memory.ReadSource(source++);
 
 		int i1, i2;
 		if (d)
@@ -517,14 +592,14 @@ TEMPLATE static uint32_t LZ77UnCompWram()
 			{
 				if (d & 0x80)
 				{
-					uint16_t data = _MMU_read08<PROCNUM>(source++) << 8;
-					data |= _MMU_read08<PROCNUM>(source++);
+					uint16_t data = memory.ReadSource(source++) << 8;
+					data |= memory.ReadSource(source++);
 					int length = (data >> 12) + 3;
 					int offset = data & 0x0FFF;
 					uint32_t windowOffset = dest - offset - 1;
 					for (i2 = 0; i2 < length; ++i2)
 					{
-						_MMU_write08<PROCNUM>(dest++, _MMU_read08<PROCNUM>(windowOffset++));
+						memory.Write8(dest++, memory.ReadDest(windowOffset++));
 						--len;
 						if (!len)
 							return 0;
@@ -532,7 +607,7 @@ TEMPLATE static uint32_t LZ77UnCompWram()
 				}
 				else
 				{
-					_MMU_write08<PROCNUM>(dest++, _MMU_read08<PROCNUM>(source++));
+					memory.Write8(dest++, memory.ReadSource(source++));
 					--len;
 					if (!len)
 						return 0;
@@ -544,7 +619,7 @@ TEMPLATE static uint32_t LZ77UnCompWram()
 		{
 			for (i1 = 0; i1 < 8; ++i1)
 			{
-				_MMU_write08<PROCNUM>(dest++, _MMU_read08<PROCNUM>(source++));
+				memory.Write8(dest++, memory.ReadSource(source++));
 				--len;
 				if (!len)
 					return 0;
@@ -554,7 +629,7 @@ TEMPLATE static uint32_t LZ77UnCompWram()
 	return 1;
 }
 
-TEMPLATE static uint32_t RLUnCompVram()
+TEMPLATE static uint32_t LZ77UnCompWram()
 {
 	uint32_t source = cpu->R[0];
 	uint32_t dest = cpu->R[1];
@@ -564,6 +639,14 @@ TEMPLATE static uint32_t RLUnCompVram()
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return 0;
 
+	BIOSDirectMemory<PROCNUM> direct;
+	if (direct.Setup(source, dest, header >> 8))
+		return LZ77UnCompWramWith(direct, source, dest, header);
+	return LZ77UnCompWramWith(BIOSMemory<PROCNUM>(), source, dest, header);
+}
+
+template<typename Memory> static uint32_t RLUnCompVramWith(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int len = header >> 8;
 	int byteCount = 0;
 	int byteShift = 0;
@@ -571,13 +654,13 @@ TEMPLATE static uint32_t RLUnCompVram()
 
 	while (len > 0)
 	{
-		uint8_t d = _MMU_read08<PROCNUM>(source++);
+		uint8_t d = memory.ReadSource(source++);
 		int l = d & 0x7F;
 
 		int i;
 		if (d & 0x80)
 		{
-			uint8_t data = _MMU_read08<PROCNUM>(source++);
+			uint8_t data = memory.ReadSource(source++);
 			l += 3;
 			for (i = 0; i < l; ++i)
 			{
@@ -587,7 +670,7 @@ TEMPLATE static uint32_t RLUnCompVram()
 
 				if (byteCount == 2)
 				{
-					_MMU_write16<PROCNUM>(dest, writeValue & 0xFFFF);
+					memory.Write16(dest, writeValue & 0xFFFF);
 					dest += 2;
 					byteCount = 0;
 					byteShift = 0;
@@ -603,13 +686,13 @@ TEMPLATE static uint32_t RLUnCompVram()
 			++l;
 			for (i = 0; i < l; ++i)
 			{
-				writeValue |= _MMU_read08<PROCNUM>(source++) << byteShift;
+				writeValue |= memory.ReadSource(source++) << byteShift;
 				byteShift += 8;
 				++byteCount;
 
 				if (byteCount == 2)
 				{
-					_MMU_write16<PROCNUM>(dest, writeValue & 0xFFFF);
+					memory.Write16(dest, writeValue & 0xFFFF);
 					dest += 2;
 					byteCount = 0;
 					byteShift = 0;
@@ -624,7 +707,7 @@ TEMPLATE static uint32_t RLUnCompVram()
 	return 1;
 }
 
-TEMPLATE static uint32_t RLUnCompWram()
+TEMPLATE static uint32_t RLUnCompVram()
 {
 	uint32_t source = cpu->R[0];
 	uint32_t dest = cpu->R[1];
@@ -634,21 +717,29 @@ TEMPLATE static uint32_t RLUnCompWram()
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return 0;
 
+	BIOSDirectMemory<PROCNUM> direct;
+	if (direct.Setup(source, dest, header >> 8))
+		return RLUnCompVramWith(direct, source, dest, header);
+	return RLUnCompVramWith(BIOSMemory<PROCNUM>(), source, dest, header);
+}
+
+template<typename Memory> static uint32_t RLUnCompWramWith(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int len = header >> 8;
 
 	while (len > 0)
 	{
-		uint8_t d = _MMU_read08<PROCNUM>(source++);
+		uint8_t d = memory.ReadSource(source++);
 		int l = d & 0x7F;
 
 		int i;
 		if (d & 0x80)
 		{
-			uint8_t data = _MMU_read08<PROCNUM>(source++);
+			uint8_t data = memory.ReadSource(source++);
 			l += 3;
 			for (i = 0; i < l; ++i)
 			{
-				_MMU_write08<PROCNUM>(dest++, data);
+				memory.Write8(dest++, data);
 				--len;
 				if (!len)
 					return 0;
@@ -659,7 +750,7 @@ TEMPLATE static uint32_t RLUnCompWram()
 			++l;
 			for (i = 0; i < l; ++i)
 			{
-				_MMU_write08<PROCNUM>(dest++,  _MMU_read08<PROCNUM>(source++));
+				memory.Write8(dest++,  memory.ReadSource(source++));
 				--len;
 				if (!len)
 					return 0;
@@ -669,17 +760,25 @@ TEMPLATE static uint32_t RLUnCompWram()
 	return 1;
 }
 
-TEMPLATE static uint32_t UnCompHuffman()
+TEMPLATE static uint32_t RLUnCompWram()
 {
 	uint32_t source = cpu->R[0];
 	uint32_t dest = cpu->R[1];
-	uint32_t header = _MMU_read08<PROCNUM>(source);
+	uint32_t header = _MMU_read32<PROCNUM>(source);
 	source += 4;
 
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return 0;
 
-	uint8_t treeSize = _MMU_read08<PROCNUM>(source++);
+	BIOSDirectMemory<PROCNUM> direct;
+	if (direct.Setup(source, dest, header >> 8))
+		return RLUnCompWramWith(direct, source, dest, header);
+	return RLUnCompWramWith(BIOSMemory<PROCNUM>(), source, dest, header);
+}
+
+template<typename Memory> static uint32_t UnCompHuffmanWith(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
+	uint8_t treeSize = memory.ReadSource(source++);
 
 	uint32_t treeStart = source;
 
@@ -688,11 +787,11 @@ TEMPLATE static uint32_t UnCompHuffman()
 	int len = header >> 8;
 
 	uint32_t mask = 0x80000000;
-	uint32_t data = _MMU_read08<PROCNUM>(source);
+	uint32_t data = memory.ReadSource(source);
 	source += 4;
 
 	int pos = 0;
-	uint8_t rootNode = _MMU_read08<PROCNUM>(treeStart);
+	uint8_t rootNode = memory.ReadSource(treeStart);
 	uint8_t currentNode = rootNode;
 	int writeData = 0;
 	int byteShift = 0;
@@ -714,14 +813,14 @@ TEMPLATE static uint32_t UnCompHuffman()
 				// right
 				if (currentNode & 0x40)
 					writeData = 1;
-				currentNode = _MMU_read08<PROCNUM>(treeStart + pos + 1);
+				currentNode = memory.ReadSource(treeStart + pos + 1);
 			}
 			else
 			{
 				// left
 				if (currentNode & 0x80)
 					writeData = 1;
-				currentNode = _MMU_read08<PROCNUM>(treeStart + pos);
+				currentNode = memory.ReadSource(treeStart + pos);
 			}
 
 			if (writeData)
@@ -738,7 +837,7 @@ TEMPLATE static uint32_t UnCompHuffman()
 				{
 					byteCount = 0;
 					byteShift = 0;
-					_MMU_write08<PROCNUM>(dest, writeValue & 0xFF);
+					memory.Write8(dest, writeValue & 0xFF);
 					writeValue = 0;
 					dest += 4;
 					len -= 4;
@@ -748,7 +847,7 @@ TEMPLATE static uint32_t UnCompHuffman()
 			if (!mask)
 			{
 				mask = 0x80000000;
-				data = _MMU_read08<PROCNUM>(source);
+				data = memory.ReadSource(source);
 				source += 4;
 			}
 		}
@@ -770,14 +869,14 @@ TEMPLATE static uint32_t UnCompHuffman()
 				// right
 				if (currentNode & 0x40)
 					writeData = 1;
-				currentNode = _MMU_read08<PROCNUM>(treeStart + pos + 1);
+				currentNode = memory.ReadSource(treeStart + pos + 1);
 			}
 			else
 			{
 				// left
 				if (currentNode & 0x80)
 					writeData = 1;
-				currentNode = _MMU_read08<PROCNUM>(treeStart + pos);
+				currentNode = memory.ReadSource(treeStart + pos);
 			}
 
 			if (writeData)
@@ -801,7 +900,7 @@ TEMPLATE static uint32_t UnCompHuffman()
 					{
 						byteCount = 0;
 						byteShift = 0;
-						_MMU_write08<PROCNUM>(dest, writeValue & 0xFF);
+						memory.Write8(dest, writeValue & 0xFF);
 						dest += 4;
 						writeValue = 0;
 						len -= 4;
@@ -815,7 +914,7 @@ TEMPLATE static uint32_t UnCompHuffman()
 			if (!mask)
 			{
 				mask = 0x80000000;
-				data = _MMU_read08<PROCNUM>(source);
+				data = memory.ReadSource(source);
 				source += 4;
 			}
 		}
@@ -823,6 +922,22 @@ TEMPLATE static uint32_t UnCompHuffman()
 	return 1;
 }
 
+TEMPLATE static uint32_t UnCompHuffman()
+{
+	uint32_t source = cpu->R[0];
+	uint32_t dest = cpu->R[1];
+	uint32_t header = _MMU_read08<PROCNUM>(source);
+	source += 4;
+
+	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
+		return 0;
+
+	BIOSDirectMemory<PROCNUM> direct;
+	if (direct.Setup(source, dest, header >> 8))
+		return UnCompHuffmanWith(direct, source, dest, header);
+	return UnCompHuffmanWith(BIOSMemory<PROCNUM>(), source, dest, header);
+}
+
 TEMPLATE static uint32_t BitUnPack()
 {
 	uint32_t source = cpu->R[0];
@@ -0,0 +1,396 @@
+/*
+ * MP2K Player - Channel structure
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Some concepts from the GB APU emulation in VBA-M
+ * http://vba-m.com/
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "Channel.h"
+#include "consts.h"
+
+Channel::Channel() : state(CS_NONE), starting(false), stopping(false), type(0), track(nullptr), order(0), midiKey(0), key(0), velocity(0), prio(0), gateTime(0),
+	rhythmPan(0), attack(0), decay(0), sustain(0), release(0), echoVolume(0), echoLength(0), envelope(0), envelopeCounter(0), rightVolume(0), leftVolume(0),
+	envelopeRight(0), envelopeLeft(0), wave(), fixed(false), reverse(false), position(0), step(0), wav(0), waveRAM(nullptr), phase(0), lfsr(0)
+{
+}
+
+// Original engine function: ply_note, the part for setting up the channel
+bool Channel::Start(const GBAMemory &memory, Track *trk, const ToneData &tone, uint8_t newKey, int8_t newRhythmPan, uint8_t newPrio)
+{
+	uint8_t newType = tone.type & TONE_CGBMASK;
+	if (!newType)
+	{
+		WaveData newWave;
+		if (!newWave.Read(memory, tone.wav))
+			return false;
+		this->wave = newWave;
+		this->fixed = !!(tone.type & TONE_FIXED);
+		this->reverse = !!(tone.type & TONE_REVERSE);
+		this->position = 0;
+	}
+	else
+	{
+		const uint8_t *newWaveRAM = nullptr;
+		if (newType == TONE_WAVE && !(newWaveRAM = memory.Pointer(tone.wav, 16)))
+			return false;
+		this->waveRAM = newWaveRAM;
+		this->wav = tone.wav;
+		this->phase = 0;
+		this->lfsr = 0x7FFF;
+	}
+
+	this->type = newType;
+	this->track = trk;
+	this->midiKey = trk->key;
+	this->key = newKey;
+	this->velocity = trk->velocity;
+	this->prio = newPrio;
+	this->gateTime = trk->gateTime;
+	this->rhythmPan = newRhythmPan;
+	this->attack = tone.attack;
+	this->decay = tone.decay;
+	this->sustain = tone.sustain;
+	this->release = tone.release;
+	this->echoVolume = trk->echoVolume;
+	this->echoLength = trk->echoLength;
+
+	this->state = CS_ATTACK;
+	this->starting = true;
+	this->stopping = false;
+	this->envelope = this->envelopeCounter = 0;
+	this->envelopeRight = this->envelopeLeft = 0;
+	return true;
+}
+
+void Channel::Kill()
+{
+	this->state = CS_NONE;
+	this->starting = this->stopping = false;
+	this->track = nullptr;
+	this->envelope = this->envelopeRight = this->envelopeLeft = 0;
+}
+
+void Channel::Release()
+{
+	if (this->state != CS_NONE)
+		this->stopping = true;
+}
+
+bool Channel::IsReleasing() const
+{
+	return this->stopping || this->state == CS_ECHO;
+}
+
+// Original engine function: ChnVolSetAsm
+void Channel::UpdateVolume()
+{
+	if (!this->track)
+		return;
+	this->rightVolume = static_cast<uint8_t>(std::min((this->velocity * (128 + this->rhythmPan) * this->track->volMR) >> 14, 255));
+	this->leftVolume = static_cast<uint8_t>(std::min((this->velocity * (127 - this->rhythmPan) * this->track->volML) >> 14, 255));
+}
+
+// The noise setting for each key from 21 up, with the shift in the upper nibble and the divisor in the lower
+static const uint8_t NoiseTable[] =
+{
+	0xD7, 0xD6, 0xD5, 0xD4, 0xC7, 0xC6, 0xC5, 0xC4, 0xB7, 0xB6, 0xB5, 0xB4, 0xA7, 0xA6, 0xA5, 0xA4, 0x97, 0x96, 0x95, 0x94,
+	0x87, 0x86, 0x85, 0x84, 0x77, 0x76, 0x75, 0x74, 0x67, 0x66, 0x65, 0x64, 0x57, 0x56, 0x55, 0x54, 0x47, 0x46, 0x45, 0x44,
+	0x37, 0x36, 0x35, 0x34, 0x27, 0x26, 0x25, 0x24, 0x17, 0x16, 0x15, 0x14, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00
+};
+
+// Original engine functions: MidiKey2Freq and MidiKeyToCgbFreq
+void Channel::UpdatePitch(uint32_t sampleRate, uint32_t pcmFreq)
+{
+	if (!this->track)
+		return;
+	int noteKey = this->key + this->track->keyM, fine = this->track->pitM;
+	if (!this->type)
+	{
+		if (this->fixed)
+			this->step = static_cast<double>(pcmFreq) / sampleRate;
+		else
+		{
+			if (noteKey > 178)
+			{
+				noteKey = 178;
+				fine = 255;
+			}
+			double freq = this->wave.freq / 1024.0 * std::pow(2.0, (noteKey - 60 + fine / 256.0) / 12.0);
+			this->step = freq / sampleRate;
+		}
+	}
+	else if (this->type == TONE_NOISE)
+	{
+		noteKey = noteKey <= 20 ? 0 : std::min(noteKey - 21, 59);
+		uint8_t noise = NoiseTable[noteKey];
+		double divisor = (noise & 7) ? (noise & 7) : 0.5;
+		this->step = 524288.0 / divisor / (2 << (noise >> 4)) / sampleRate;
+	}
+	else
+	{
+		if (noteKey < 36)
+		{
+			noteKey = 36;
+			fine = 0;
+		}
+		else if (noteKey >= 130)
+		{
+			noteKey = 130;
+			fine = 0;
+		}
+		double freq = 440.0 * std::pow(2.0, (noteKey - 69 + fine / 256.0) / 12.0);
+		// The wave channel takes twice as long to go through its 32 samples as the square channels take for their 8 steps
+		if (this->type == TONE_WAVE)
+			freq /= 2;
+		this->step = freq / sampleRate;
+	}
+}
+
+void Channel::EchoOrKill()
+{
+	if (!this->echoVolume)
+		this->Kill();
+	else
+	{
+		this->state = CS_ECHO;
+		this->envelope = this->echoVolume;
+	}
+}
+
+// Original engine function: SoundMainRAM, the part for the envelope
+void Channel::UpdateDirectSoundEnvelope(uint8_t masterVolume)
+{
+	if (this->state == CS_ECHO)
+	{
+		if (!this->echoLength || !--this->echoLength)
+		{
+			this->Kill();
+			return;
+		}
+	}
+	else if (this->stopping)
+	{
+		this->envelope = (this->envelope * this->release) >> 8;
+		if (this->envelope <= this->echoVolume)
+		{
+			this->EchoOrKill();
+			if (this->state == CS_NONE)
+				return;
+		}
+	}
+	else if (this->state == CS_DECAY)
+	{
+		this->envelope = (this->envelope * this->decay) >> 8;
+		if (this->envelope <= this->sustain)
+		{
+			this->envelope = this->sustain;
+			if (!this->sustain)
+			{
+				this->EchoOrKill();
+				if (this->state == CS_NONE)
+					return;
+			}
+			else
+				this->state = CS_SUSTAIN;
+		}
+	}
+	else if (this->state == CS_ATTACK)
+	{
+		this->envelope += this->attack;
+		if (this->envelope >= 0xFF)
+		{
+			this->envelope = 0xFF;
+			this->state = CS_DECAY;
+		}
+	}
+
+	int level = ((masterVolume + 1) * this->envelope) >> 4;
+	this->envelopeRight = (level * this->rightVolume) >> 8;
+	this->envelopeLeft = (level * this->leftVolume) >> 8;
+}
+
+// Original engine function: CgbSound, the part for the envelope.  The engine steps the hardware's volume from 0 to 15 itself, one step
+// every few frames as given by the attack, decay and release, and the GB channels can only be panned to the left, right or center.
+void Channel::UpdateCGBEnvelope()
+{
+	int goal = std::min((this->rightVolume + this->leftVolume) >> 4, 15);
+	int sustainLevel = (goal * this->sustain + 15) >> 4;
+
+	if (this->stopping)
+	{
+		if (!this->release || this->envelope <= 0)
+		{
+			this->Kill();
+			return;
+		}
+		if (++this->envelopeCounter >= this->release)
+		{
+			this->envelopeCounter = 0;
+			if (--this->envelope <= 0)
+			{
+				this->Kill();
+				return;
+			}
+		}
+	}
+	else
+	{
+		if (this->state == CS_ATTACK)
+		{
+			if (!this->attack)
+				this->envelope = goal;
+			else if (++this->envelopeCounter >= this->attack)
+			{
+				this->envelopeCounter = 0;
+				++this->envelope;
+			}
+			if (this->envelope >= goal)
+			{
+				this->envelope = goal;
+				this->envelopeCounter = 0;
+				this->state = CS_DECAY;
+			}
+		}
+		else if (this->state == CS_DECAY)
+		{
+			if (!this->decay)
+				this->envelope = sustainLevel;
+			else if (++this->envelopeCounter >= this->decay)
+			{
+				this->envelopeCounter = 0;
+				--this->envelope;
+			}
+			if (this->envelope <= sustainLevel)
+			{
+				this->envelope = sustainLevel;
+				if (!sustainLevel)
+				{
+					this->Kill();
+					return;
+				}
+				this->state = CS_SUSTAIN;
+			}
+		}
+		else if (this->state == CS_SUSTAIN)
+			this->envelope = sustainLevel;
+	}
+
+	bool right = true, left = true;
+	if (this->rightVolume >= this->leftVolume)
+	{
+		if (this->rightVolume / 2 >= this->leftVolume)
+			left = false;
+	}
+	else if (this->leftVolume / 2 >= this->rightVolume)
+		right = false;
+	this->envelopeRight = right ? this->envelope : 0;
+	this->envelopeLeft = left ? this->envelope : 0;
+}
+
+// Called once per frame, a note that was started and released within the same frame is never heard, the same as with the engine
+void Channel::UpdateEnvelope(uint8_t masterVolume)
+{
+	if (this->state == CS_NONE)
+		return;
+	if (this->starting)
+	{
+		this->starting = false;
+		if (this->stopping)
+		{
+			this->Kill();
+			return;
+		}
+	}
+	if (this->type)
+		this->UpdateCGBEnvelope();
+	else
+		this->UpdateDirectSoundEnvelope(masterVolume);
+}
+
+// Original engine function: SoundMainRAM, the part for mixing, with linear interpolation between samples
+void Channel::MixDirectSound(int &left, int &right)
+{
+	if (this->state == CS_NONE || this->starting)
+		return;
+
+	auto index = static_cast<uint32_t>(this->position);
+	int sample, nextSample;
+	if (this->reverse)
+	{
+		sample = this->wave.data[this->wave.size - 1 - index];
+		nextSample = index + 1 < this->wave.size ? this->wave.data[this->wave.size - 2 - index] : sample;
+	}
+	else
+	{
+		sample = this->wave.data[index];
+		if (index + 1 < this->wave.size)
+			nextSample = this->wave.data[index + 1];
+		else
+			nextSample = this->wave.loops ? this->wave.data[this->wave.loopStart] : sample;
+	}
+	sample += static_cast<int>((nextSample - sample) * (this->position - index));
+	right += (sample * this->envelopeRight) >> 8;
+	left += (sample * this->envelopeLeft) >> 8;
+
+	this->position += this->step;
+	if (this->position >= this->wave.size)
+	{
+		if (this->wave.loops && !this->reverse)
+		{
+			double loopLength = this->wave.size - this->wave.loopStart;
+			this->position = this->wave.loopStart + std::fmod(this->position - this->wave.size, loopLength);
+		}
+		else
+			this->Kill();
+	}
+}
+
+// Each CGB channel's output is between -1 and 1 times its envelope, which goes from 0 to 15
+void Channel::MixCGB(int &left, int &right)
+{
+	if (this->state == CS_NONE || this->starting)
+		return;
+
+	static const double SquareDuties[] = { 0.125, 0.25, 0.5, 0.75 };
+
+	int sampleRight, sampleLeft;
+	if (this->type == TONE_WAVE)
+	{
+		int index = static_cast<int>(this->phase * 32) & 31;
+		uint8_t data = this->waveRAM[index >> 1];
+		int sample = 2 * ((index & 1) ? (data & 0xF) : (data >> 4)) - 15;
+		sampleRight = sample * this->envelopeRight / 15;
+		sampleLeft = sample * this->envelopeLeft / 15;
+		this->phase += this->step;
+		this->phase -= std::floor(this->phase);
+	}
+	else if (this->type == TONE_NOISE)
+	{
+		int sign = (this->lfsr & 1) ? -1 : 1;
+		sampleRight = sign * this->envelopeRight;
+		sampleLeft = sign * this->envelopeLeft;
+		this->phase += this->step;
+		for (; this->phase >= 1; --this->phase)
+		{
+			uint16_t feedback = (this->lfsr ^ (this->lfsr >> 1)) & 1;
+			this->lfsr = (this->lfsr >> 1) | (feedback << 14);
+			// The wav of a noise tone picks the shorter 7-bit period
+			if (this->wav & 1)
+				this->lfsr = (this->lfsr & ~0x40) | (feedback << 6);
+		}
+	}
+	else
+	{
+		int sign = this->phase < SquareDuties[this->wav & 3] ? 1 : -1;
+		sampleRight = sign * this->envelopeRight;
+		sampleLeft = sign * this->envelopeLeft;
+		this->phase += this->step;
+		this->phase -= std::floor(this->phase);
+	}
+	right += sampleRight;
+	left += sampleLeft;
+}
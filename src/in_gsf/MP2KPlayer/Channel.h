@@ -0,0 +1,66 @@
+/*
+ * MP2K Player - Channel structure
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Some concepts from the GB APU emulation in VBA-M
+ * http://vba-m.com/
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "ToneData.h"
+#include "Track.h"
+
+/*
+ * A voice being played, either one of the engine's direct sound channels,
+ * which it mixes in software, or one of the four GB sound channels (CGB
+ * channels in the engine's terms), which are synthesized here in place of the
+ * hardware.  Both kinds are mixed straight to the output sample rate, instead
+ * of at the engine's own mixing rate first.
+ */
+struct Channel
+{
+	int state;
+	bool starting, stopping;
+	uint8_t type; // 0 for direct sound, otherwise the CGB channel from 1 to 4
+	Track *track;
+	uint32_t order;
+
+	uint8_t midiKey, key, velocity, prio, gateTime;
+	int8_t rhythmPan;
+	uint8_t attack, decay, sustain, release, echoVolume, echoLength;
+
+	int envelope, envelopeCounter;
+	uint8_t rightVolume, leftVolume;
+	int envelopeRight, envelopeLeft;
+
+	// Direct sound
+	WaveData wave;
+	bool fixed, reverse;
+	double position, step;
+
+	// CGB
+	uint32_t wav;
+	const uint8_t *waveRAM;
+	double phase;
+	uint16_t lfsr;
+
+	Channel();
+
+	bool Start(const GBAMemory &memory, Track *track, const ToneData &tone, uint8_t key, int8_t rhythmPan, uint8_t prio);
+	void Kill();
+	void Release();
+	bool IsReleasing() const;
+	void UpdateVolume();
+	void UpdatePitch(uint32_t sampleRate, uint32_t pcmFreq);
+	void UpdateEnvelope(uint8_t masterVolume);
+	void MixDirectSound(int &left, int &right);
+	void MixCGB(int &left, int &right);
+
+private:
+	void EchoOrKill();
+	void UpdateDirectSoundEnvelope(uint8_t masterVolume);
+	void UpdateCGBEnvelope();
+};
@@ -0,0 +1,77 @@
+/*
+ * MP2K Player - GBA memory view
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "XSFCommon.h"
+
+/*
+ * A read-only view of the parts of the GBA's address space that the sound
+ * engine's structures, sequences and samples can be in.  Every read is
+ * bounds checked, so a bad pointer in a song reads as 0 instead of crashing.
+ */
+
+struct GBAMemory
+{
+	const uint8_t *ewram;
+	const uint8_t *iwram;
+	const uint8_t *rom;
+	uint32_t romSize;
+
+	GBAMemory() : ewram(nullptr), iwram(nullptr), rom(nullptr), romSize(0)
+	{
+	}
+
+	// Gets a pointer to size bytes at the given address, or nullptr if they are not all within one region
+	const uint8_t *Pointer(uint32_t address, uint32_t size = 1) const
+	{
+		const uint8_t *base;
+		uint32_t offset, length;
+		switch (address >> 24)
+		{
+			case 0x02:
+				base = this->ewram;
+				offset = address & 0xFFFFFF;
+				length = 0x40000;
+				break;
+			case 0x03:
+				base = this->iwram;
+				offset = address & 0xFFFFFF;
+				length = 0x8000;
+				break;
+			case 0x08:
+			case 0x09:
+				base = this->rom;
+				offset = address & 0x1FFFFFF;
+				length = this->romSize;
+				break;
+			default:
+				return nullptr;
+		}
+		if (!base || offset >= length || size > length - offset)
+			return nullptr;
+		return base + offset;
+	}
+
+	uint8_t Read8(uint32_t address) const
+	{
+		auto data = this->Pointer(address);
+		return data ? *data : 0;
+	}
+
+	uint16_t Read16(uint32_t address) const
+	{
+		auto data = this->Pointer(address, 2);
+		return data ? data[0] | (data[1] << 8) : 0;
+	}
+
+	uint32_t Read32(uint32_t address) const
+	{
+		auto data = this->Pointer(address, 4);
+		return data ? Get32BitsLE(data) : 0;
+	}
+};
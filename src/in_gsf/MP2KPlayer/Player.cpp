@@ -0,0 +1,290 @@
+/*
+ * MP2K Player - Player structures
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "Player.h"
+
+// Levels of the direct sound and CGB output, relative to each other the same as in the emulated output
+static const int DirectSoundScale = 84;
+static const int CGBScale = 164;
+
+MusicPlayer::MusicPlayer() : active(false), prio(0), nTracks(0), tone(0), tempoD(0), tempoU(0), tempoI(0), tempoC(0), ply(nullptr)
+{
+}
+
+// Original engine function: MPlayStart
+bool MusicPlayer::Setup(Player *player, uint32_t songHeader)
+{
+	auto &memory = player->memory;
+	auto header = memory.Pointer(songHeader, 8);
+	if (!header || !header[0] || header[0] > MP2K_MAXTRACKS)
+		return false;
+	uint8_t trackCount = header[0];
+	uint32_t voiceGroup = Get32BitsLE(&header[4]);
+	auto parts = memory.Pointer(songHeader + 8, trackCount * 4);
+	if (!parts || !memory.Pointer(voiceGroup, 12))
+		return false;
+	for (uint8_t i = 0; i < trackCount; ++i)
+		if (!memory.Pointer(Get32BitsLE(&parts[i * 4])))
+			return false;
+
+	this->ply = player;
+	this->active = true;
+	this->prio = header[2];
+	this->nTracks = trackCount;
+	this->tone = voiceGroup;
+	this->tempoD = this->tempoI = MP2K_TEMPOBASE;
+	this->tempoU = 0x100;
+	this->tempoC = 0;
+	for (uint8_t i = 0; i < trackCount; ++i)
+		this->tracks[i].Init(this, player, Get32BitsLE(&parts[i * 4]));
+	return true;
+}
+
+void MusicPlayer::SetTempo(uint16_t tempo)
+{
+	this->tempoD = tempo;
+	this->tempoI = (this->tempoD * this->tempoU) >> 8;
+}
+
+// Original engine function: MPlayMain
+void MusicPlayer::Run()
+{
+	if (!this->active)
+		return;
+
+	this->tempoC += this->tempoI;
+	while (this->tempoC >= MP2K_TEMPOBASE)
+	{
+		bool anyActive = false;
+		for (uint8_t i = 0; i < this->nTracks; ++i)
+		{
+			auto &track = this->tracks[i];
+			if (!track.active)
+				continue;
+			track.Run();
+			anyActive = anyActive || track.active;
+		}
+		this->tempoC -= MP2K_TEMPOBASE;
+		if (!anyActive)
+		{
+			this->active = false;
+			break;
+		}
+	}
+
+	for (uint8_t i = 0; i < this->nTracks; ++i)
+		if (this->tracks[i].updateFlags.any())
+			this->ply->UpdateTrackChannels(&this->tracks[i]);
+}
+
+Player::Player() : memory(), masterVolume(0), maxChannels(0), reverb(0), pcmDmaPeriod(0), pcmFreq(0), nMusicPlayers(0), noteOrder(0), sampleRate(0), samplesPerFrame(0),
+	samplesUntilNextFrame(0), reverbBufferLeft(), reverbBufferRight(), reverbPos(0), reverbNearDelay(0), mutes()
+{
+}
+
+// Takes over from the engine if the game has already started at least one song with it, the songs are restarted from their beginnings
+bool Player::Setup(const GBAMemory &newMemory, uint32_t newSampleRate)
+{
+	this->memory = newMemory;
+	auto info = this->memory.Pointer(this->memory.Read32(SoundInfoPointerAddress), 0x28);
+	if (!info || Get32BitsLE(&info[0]) - MP2K_IDENT > 1 || !info[6])
+		return false;
+	this->reverb = info[5];
+	this->maxChannels = std::min<uint8_t>(info[6], MP2K_MAXDSCHANNELS);
+	this->masterVolume = info[7] & 0xF;
+	this->pcmDmaPeriod = std::max<uint8_t>(info[0xB], 2);
+	this->pcmFreq = Get32BitsLE(&info[0x14]);
+
+	// The music players are chained together from the last one the game opened back to the first one
+	this->nMusicPlayers = 0;
+	uint32_t mplayInfo = Get32BitsLE(&info[0x24]);
+	bool more = !!Get32BitsLE(&info[0x20]);
+	for (int i = 0; i < MP2K_MAXPLAYERS && more; ++i)
+	{
+		auto mplay = this->memory.Pointer(mplayInfo, 0x40);
+		if (!mplay || Get32BitsLE(&mplay[0x34]) - MP2K_IDENT > 1)
+			break;
+		uint32_t status = Get32BitsLE(&mplay[0x04]);
+		if ((status & 0xFFFF) && !(status & 0x80000000) && this->musicPlayers[this->nMusicPlayers].Setup(this, Get32BitsLE(&mplay[0x00])))
+			++this->nMusicPlayers;
+		more = !!Get32BitsLE(&mplay[0x38]);
+		mplayInfo = Get32BitsLE(&mplay[0x3C]);
+	}
+	if (!this->nMusicPlayers)
+		return false;
+
+	std::fill_n(&this->channels[0], MP2K_MAXDSCHANNELS + MP2K_CGBCHANNELS, Channel());
+	this->noteOrder = 0;
+
+	this->sampleRate = newSampleRate;
+	this->samplesPerFrame = static_cast<double>(this->sampleRate) * CyclesPerFrame / GBA_CLOCK;
+	this->samplesUntilNextFrame = 0;
+
+	// The engine's reverb mixes in what it mixed into its buffer the last time around, which was as many frames ago as the buffer holds,
+	// and what it mixed one frame later than that
+	auto farDelay = static_cast<size_t>(std::lround(this->pcmDmaPeriod * this->samplesPerFrame));
+	this->reverbNearDelay = static_cast<size_t>(std::lround((this->pcmDmaPeriod - 1) * this->samplesPerFrame));
+	this->reverbBufferLeft.assign(farDelay, 0);
+	this->reverbBufferRight.assign(farDelay, 0);
+	this->reverbPos = 0;
+
+	return true;
+}
+
+// Original engine function: ply_note, the part for picking a channel.  Each CGB channel only plays its own type of tone, and for direct sound a
+// free channel is used first, then the lowest priority channel that is being released, then the lowest priority channel that isn't.
+Channel *Player::ChannelAlloc(int type, int prio)
+{
+	if (type)
+	{
+		auto chn = &this->channels[MP2K_MAXDSCHANNELS + type - 1];
+		if (chn->state != CS_NONE && !chn->IsReleasing() && chn->prio > prio)
+			return nullptr;
+		return chn;
+	}
+
+	Channel *best = nullptr;
+	for (uint8_t i = 0; i < this->maxChannels; ++i)
+	{
+		auto chn = &this->channels[i];
+		if (chn->state == CS_NONE)
+			return chn;
+		bool releasing = chn->IsReleasing();
+		if (!releasing && chn->prio > prio)
+			continue;
+		if (best)
+		{
+			bool bestReleasing = best->IsReleasing();
+			if (releasing != bestReleasing)
+			{
+				if (!releasing)
+					continue;
+			}
+			else if (chn->prio > best->prio || (chn->prio == best->prio && chn->order > best->order))
+				continue;
+		}
+		best = chn;
+	}
+	return best;
+}
+
+void Player::NoteOn(Track *track)
+{
+	ToneData tone;
+	uint8_t key;
+	int8_t rhythmPan;
+	if (!track->tone.Resolve(this->memory, track->key, tone, key, rhythmPan))
+		return;
+
+	int prio = std::min(track->mplay->prio + track->prio, 255);
+	auto chn = this->ChannelAlloc(tone.type & TONE_CGBMASK, prio);
+	if (!chn || !chn->Start(this->memory, track, tone, key, rhythmPan, static_cast<uint8_t>(prio)))
+		return;
+	chn->order = this->noteOrder++;
+	track->UpdateVolPitch();
+	chn->UpdateVolume();
+	chn->UpdatePitch(this->sampleRate, this->pcmFreq);
+}
+
+// Original engine function: ply_endtie, only the first matching note is released
+void Player::EndTie(Track *track, uint8_t key)
+{
+	for (auto &chn : this->channels)
+		if (chn.track == track && chn.midiKey == key && chn.state != CS_NONE && !chn.IsReleasing())
+		{
+			chn.Release();
+			break;
+		}
+}
+
+void Player::ReleaseTrackChannels(Track *track)
+{
+	for (auto &chn : this->channels)
+		if (chn.track == track)
+			chn.Release();
+}
+
+void Player::UpdateGateTimes(Track *track)
+{
+	for (auto &chn : this->channels)
+		if (chn.track == track && !chn.IsReleasing() && chn.gateTime && !--chn.gateTime)
+			chn.Release();
+}
+
+void Player::UpdateTrackChannels(Track *track)
+{
+	track->UpdateVolPitch();
+	for (auto &chn : this->channels)
+	{
+		if (chn.track != track)
+			continue;
+		if (track->updateFlags[TUF_VOL])
+			chn.UpdateVolume();
+		if (track->updateFlags[TUF_PITCH])
+			chn.UpdatePitch(this->sampleRate, this->pcmFreq);
+	}
+	track->updateFlags.reset();
+}
+
+// Original engine function: SoundMain, which is run once per VBlank
+void Player::Frame()
+{
+	for (uint8_t i = 0; i < this->nMusicPlayers; ++i)
+		this->musicPlayers[i].Run();
+	for (auto &chn : this->channels)
+		chn.UpdateEnvelope(this->masterVolume);
+}
+
+void Player::GenerateSamples(std::vector<uint8_t> &buf, unsigned offset, unsigned samples)
+{
+	size_t reverbLength = this->reverbBufferLeft.size();
+	for (unsigned smpl = 0; smpl < samples; ++smpl)
+	{
+		if (this->samplesUntilNextFrame <= 0)
+		{
+			this->Frame();
+			this->samplesUntilNextFrame += this->samplesPerFrame;
+		}
+		--this->samplesUntilNextFrame;
+
+		// Direct sound is mixed the same as the engine mixes it into its 8-bit buffer, reverb included
+		int dsLeft = 0, dsRight = 0;
+		if (this->reverb)
+		{
+			size_t nearPos = (this->reverbPos + reverbLength - this->reverbNearDelay) % reverbLength;
+			int value = ((this->reverbBufferLeft[this->reverbPos] + this->reverbBufferRight[this->reverbPos] + this->reverbBufferLeft[nearPos] + this->reverbBufferRight[nearPos]) *
+				this->reverb) >> 9;
+			if (value & 0x80)
+				++value;
+			dsLeft = dsRight = value;
+		}
+		for (int i = 0; i < MP2K_MAXDSCHANNELS; ++i)
+			this->channels[i].MixDirectSound(dsLeft, dsRight);
+		dsLeft = std::min(std::max(dsLeft, -128), 127);
+		dsRight = std::min(std::max(dsRight, -128), 127);
+		this->reverbBufferLeft[this->reverbPos] = static_cast<int8_t>(dsLeft);
+		this->reverbBufferRight[this->reverbPos] = static_cast<int8_t>(dsRight);
+		this->reverbPos = (this->reverbPos + 1) % reverbLength;
+
+		int cgbLeft = 0, cgbRight = 0;
+		for (int i = 0; i < MP2K_CGBCHANNELS; ++i)
+			if (!this->mutes[MUTE_SQUARE1 + i])
+				this->channels[MP2K_MAXDSCHANNELS + i].MixCGB(cgbLeft, cgbRight);
+
+		if (this->mutes[MUTE_DSLEFT])
+			dsLeft = 0;
+		if (this->mutes[MUTE_DSRIGHT])
+			dsRight = 0;
+		int left = std::min(std::max(dsLeft * DirectSoundScale + cgbLeft * CGBScale, -0x8000), 0x7FFF);
+		int right = std::min(std::max(dsRight * DirectSoundScale + cgbRight * CGBScale, -0x8000), 0x7FFF);
+		buf[offset++] = left & 0xFF;
+		buf[offset++] = (left >> 8) & 0xFF;
+		buf[offset++] = right & 0xFF;
+		buf[offset++] = (right >> 8) & 0xFF;
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * MP2K Player - Player structures
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#pragma once
+
+#include <bitset>
+#include <vector>
+#include "GBAMemory.h"
+#include "Track.h"
+#include "Channel.h"
+#include "consts.h"
+
+/*
+ * One of the engine's music players (MusicPlayerInfo in the engine), which
+ * plays a single song.
+ */
+struct MusicPlayer
+{
+	bool active;
+	uint8_t prio, nTracks;
+	uint32_t tone; // The song's voice group
+	uint16_t tempoD, tempoU, tempoI, tempoC;
+	Player *ply;
+
+	Track tracks[MP2K_MAXTRACKS];
+
+	MusicPlayer();
+
+	bool Setup(Player *ply, uint32_t songHeader);
+	void SetTempo(uint16_t tempo);
+	void Run();
+};
+
+/*
+ * The engine as a whole (SoundInfo in the engine), which takes over the songs
+ * that the game started with the engine and mixes all of their channels.
+ */
+struct Player
+{
+	GBAMemory memory;
+	uint8_t masterVolume, maxChannels, reverb, pcmDmaPeriod;
+	uint32_t pcmFreq;
+
+	uint8_t nMusicPlayers;
+	MusicPlayer musicPlayers[MP2K_MAXPLAYERS];
+	Channel channels[MP2K_MAXDSCHANNELS + MP2K_CGBCHANNELS];
+	uint32_t noteOrder;
+
+	uint32_t sampleRate;
+	double samplesPerFrame, samplesUntilNextFrame;
+	std::vector<int8_t> reverbBufferLeft, reverbBufferRight;
+	size_t reverbPos, reverbNearDelay;
+	std::bitset<MUTE_BITS> mutes;
+
+	Player();
+
+	bool Setup(const GBAMemory &memory, uint32_t sampleRate);
+	Channel *ChannelAlloc(int type, int prio);
+	void NoteOn(Track *track);
+	void EndTie(Track *track, uint8_t key);
+	void ReleaseTrackChannels(Track *track);
+	void UpdateGateTimes(Track *track);
+	void UpdateTrackChannels(Track *track);
+	void Frame();
+	void GenerateSamples(std::vector<uint8_t> &buf, unsigned offset, unsigned samples);
+};
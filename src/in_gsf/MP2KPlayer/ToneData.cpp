@@ -0,0 +1,81 @@
+/*
+ * MP2K Player - ToneData and WaveData structures
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#include "ToneData.h"
+#include "consts.h"
+
+ToneData::ToneData() : type(TONE_SQUARE1), key(0), length(0), panSweep(0), wav(0), attack(0), decay(0), sustain(0), release(0)
+{
+}
+
+bool ToneData::Read(const GBAMemory &memory, uint32_t address)
+{
+	auto data = memory.Pointer(address, 12);
+	if (!data)
+		return false;
+	this->type = data[0];
+	this->key = data[1];
+	this->length = data[2];
+	this->panSweep = data[3];
+	this->wav = Get32BitsLE(&data[4]);
+	this->attack = data[8];
+	this->decay = data[9];
+	this->sustain = data[10];
+	this->release = data[11];
+	return true;
+}
+
+// Finds the tone that actually plays for a note, following a key split or rhythm part down to the instrument within it.
+// Rhythm parts play every instrument at that instrument's own key, and can also give it its own pan.
+bool ToneData::Resolve(const GBAMemory &memory, uint8_t noteKey, ToneData &tone, uint8_t &playKey, int8_t &rhythmPan) const
+{
+	playKey = noteKey;
+	rhythmPan = 0;
+	if (!(this->type & (TONE_KEYSPLIT | TONE_RHYTHM)))
+	{
+		tone = *this;
+		return true;
+	}
+
+	uint32_t index = noteKey;
+	if (this->type & TONE_KEYSPLIT)
+	{
+		// For a key split, the ADSR bytes are instead a pointer to the table of which instrument each key uses
+		uint32_t keySplitTable = this->attack | (this->decay << 8) | (this->sustain << 16) | (this->release << 24);
+		index = memory.Read8(keySplitTable + noteKey);
+	}
+	if (!tone.Read(memory, this->wav + index * 12) || (tone.type & (TONE_KEYSPLIT | TONE_RHYTHM)))
+		return false;
+	if (this->type & TONE_RHYTHM)
+	{
+		playKey = tone.key;
+		if (tone.panSweep & 0x80)
+			rhythmPan = static_cast<int8_t>((tone.panSweep - 0xC0) * 2);
+	}
+	return true;
+}
+
+WaveData::WaveData() : loops(false), freq(0), loopStart(0), size(0), data(nullptr)
+{
+}
+
+bool WaveData::Read(const GBAMemory &memory, uint32_t address)
+{
+	auto header = memory.Pointer(address, 16);
+	// A type other than 0 is a compressed sample, which only a few games' modified engines know how to play
+	if (!header || header[0] || header[1])
+		return false;
+	this->loops = !!(header[3] & 0xC0);
+	this->freq = Get32BitsLE(&header[4]);
+	this->loopStart = Get32BitsLE(&header[8]);
+	this->size = Get32BitsLE(&header[12]);
+	this->data = reinterpret_cast<const int8_t *>(memory.Pointer(address + 16, this->size));
+	if (!this->data || !this->size)
+		return false;
+	if (this->loopStart >= this->size)
+		this->loops = false;
+	return true;
+}
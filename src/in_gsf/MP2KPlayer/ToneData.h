@@ -0,0 +1,40 @@
+/*
+ * MP2K Player - ToneData and WaveData structures
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "GBAMemory.h"
+
+/*
+ * A single 12-byte entry of a voice group.  What wav points to depends on the
+ * type: a WaveData for direct sound, the duty cycle for a square wave, 16
+ * bytes of 4-bit samples for the wave channel, the period type for noise, and
+ * another voice group for key splits and rhythm (drum) parts.
+ */
+struct ToneData
+{
+	uint8_t type, key, length, panSweep;
+	uint32_t wav;
+	uint8_t attack, decay, sustain, release;
+
+	ToneData();
+
+	bool Read(const GBAMemory &memory, uint32_t address);
+	bool Resolve(const GBAMemory &memory, uint8_t noteKey, ToneData &tone, uint8_t &playKey, int8_t &rhythmPan) const;
+};
+
+struct WaveData
+{
+	bool loops;
+	uint32_t freq; // In 1/1024ths of a Hz, for the sample played at middle C
+	uint32_t loopStart, size;
+	const int8_t *data;
+
+	WaveData();
+
+	bool Read(const GBAMemory &memory, uint32_t address);
+};
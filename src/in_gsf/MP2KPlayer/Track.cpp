@@ -0,0 +1,390 @@
+/*
+ * MP2K Player - Track structure
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#include <algorithm>
+#include "Track.h"
+#include "Player.h"
+
+// Lengths in ticks of the wait commands (W00 through W96) and the notes (N01 through N96, index 0 being a tie)
+static const uint8_t ClockTable[] =
+{
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+	28, 30, 32, 36, 40, 42, 44, 48, 52, 54, 56, 60, 64, 66, 68, 72, 76, 78, 80, 84, 88, 90, 92, 96
+};
+
+// A track that jumps around without ever waiting would hang the engine on the real hardware, here it is stopped instead
+static const int MaxCommandsPerTick = 4096;
+
+enum
+{
+	CMD_FINE = 0xB1,
+	CMD_GOTO = 0xB2,
+	CMD_PATT = 0xB3,
+	CMD_PEND = 0xB4,
+	CMD_REPT = 0xB5,
+	CMD_MEMACC = 0xB9,
+	CMD_PRIO = 0xBA,
+	CMD_TEMPO = 0xBB,
+	CMD_KEYSH = 0xBC,
+	CMD_VOICE = 0xBD,
+	CMD_VOL = 0xBE,
+	CMD_PAN = 0xBF,
+	CMD_BEND = 0xC0,
+	CMD_BENDR = 0xC1,
+	CMD_LFOS = 0xC2,
+	CMD_LFODL = 0xC3,
+	CMD_MOD = 0xC4,
+	CMD_MODT = 0xC5,
+	CMD_TUNE = 0xC8,
+	CMD_XCMD = 0xCD,
+	CMD_EOT = 0xCE,
+	CMD_TIE = 0xCF
+};
+
+Track::Track()
+{
+	this->Zero();
+}
+
+void Track::Init(MusicPlayer *musicPlayer, Player *player, uint32_t dataPos)
+{
+	this->Zero();
+	this->active = true;
+	this->mplay = musicPlayer;
+	this->ply = player;
+	this->pos = dataPos;
+}
+
+// These are the values the engine gives a track when it starts a song
+void Track::Zero()
+{
+	this->active = false;
+	this->mplay = nullptr;
+	this->ply = nullptr;
+
+	this->pos = 0;
+	std::fill_n(&this->stack[0], MP2K_PATTERNDEPTH, 0);
+	this->stackPos = this->repeatCount = 0;
+	this->runningStatus = 0;
+
+	this->wait = 0;
+	this->gateTime = this->key = this->velocity = 0;
+	this->prio = 0;
+	this->tone = ToneData();
+
+	this->vol = 0;
+	this->volX = 64;
+	this->pan = this->bend = this->tune = this->keyShift = 0;
+	this->bendRange = 2;
+
+	this->lfoSpeed = 22;
+	this->lfoSpeedC = this->lfoDelay = this->lfoDelayC = this->mod = this->modType = 0;
+	this->modM = 0;
+
+	this->echoVolume = this->echoLength = 0;
+
+	this->volMR = this->volML = 0;
+	this->keyM = 0;
+	this->pitM = 0;
+
+	this->updateFlags.reset();
+}
+
+void Track::Stop()
+{
+	this->ply->ReleaseTrackChannels(this);
+	this->active = false;
+}
+
+uint8_t Track::Peek8() const
+{
+	return this->ply->memory.Read8(this->pos);
+}
+
+uint8_t Track::Read8()
+{
+	return this->ply->memory.Read8(this->pos++);
+}
+
+uint32_t Track::Read32()
+{
+	uint32_t value = this->ply->memory.Read32(this->pos);
+	this->pos += 4;
+	return value;
+}
+
+void Track::ClearModulation()
+{
+	this->lfoSpeedC = 0;
+	if (this->modM)
+	{
+		this->modM = 0;
+		this->updateFlags.set(this->modType ? TUF_VOL : TUF_PITCH);
+	}
+}
+
+// Original engine functions: TrkVolPitSet
+void Track::UpdateVolPitch()
+{
+	int x = (this->vol * this->volX) >> 5;
+	if (this->modType == 1)
+		x = (x * (this->modM + 128)) >> 7;
+	int y = 2 * this->pan;
+	if (this->modType == 2)
+		y += this->modM;
+	y = std::min(std::max(y, -128), 127);
+	this->volMR = static_cast<uint8_t>(((y + 128) * x) >> 8);
+	this->volML = static_cast<uint8_t>(((127 - y) * x) >> 8);
+
+	int pitch = (this->tune + this->bend * this->bendRange) * 4 + (this->keyShift << 8);
+	if (!this->modType)
+		pitch += 16 * this->modM;
+	this->keyM = static_cast<int8_t>(pitch >> 8);
+	this->pitM = static_cast<uint8_t>(pitch & 0xFF);
+}
+
+// The optional bytes after a note are the key, velocity and additional gate time, each one only if the one before it was given
+void Track::Note(uint8_t cmd)
+{
+	this->gateTime = ClockTable[cmd - CMD_TIE];
+	if (this->Peek8() < 0x80)
+	{
+		this->key = this->Read8();
+		if (this->Peek8() < 0x80)
+		{
+			this->velocity = this->Read8();
+			if (this->Peek8() < 0x80)
+				this->gateTime += this->Read8();
+		}
+	}
+
+	if (this->lfoDelay)
+	{
+		this->lfoDelayC = this->lfoDelay;
+		this->ClearModulation();
+	}
+	this->ply->NoteOn(this);
+}
+
+void Track::EndTie()
+{
+	if (this->Peek8() < 0x80)
+		this->key = this->Read8();
+	this->ply->EndTie(this, this->key);
+}
+
+void Track::ExtendedCommand()
+{
+	uint8_t type = this->Read8();
+	switch (type)
+	{
+		case 0x01:
+			this->tone.wav = this->Read32();
+			break;
+		case 0x02:
+			this->tone.type = this->Read8();
+			break;
+		case 0x04:
+			this->tone.attack = this->Read8();
+			break;
+		case 0x05:
+			this->tone.decay = this->Read8();
+			break;
+		case 0x06:
+			this->tone.sustain = this->Read8();
+			break;
+		case 0x07:
+			this->tone.release = this->Read8();
+			break;
+		case 0x08:
+			this->echoVolume = this->Read8();
+			break;
+		case 0x09:
+			this->echoLength = this->Read8();
+			break;
+		case 0x0A:
+			this->tone.length = this->Read8();
+			break;
+		case 0x0B:
+			this->tone.panSweep = this->Read8();
+			break;
+		case 0x0C:
+			this->pos += 2;
+			break;
+		case 0x0D:
+			this->pos += 4;
+			break;
+		default:
+			++this->pos;
+	}
+}
+
+void Track::Command(uint8_t cmd)
+{
+	switch (cmd)
+	{
+		case CMD_GOTO:
+			this->pos = this->Read32();
+			break;
+		case CMD_PATT:
+		{
+			uint32_t dest = this->Read32();
+			if (this->stackPos < MP2K_PATTERNDEPTH)
+			{
+				this->stack[this->stackPos++] = this->pos;
+				this->pos = dest;
+			}
+			break;
+		}
+		case CMD_PEND:
+			if (this->stackPos)
+				this->pos = this->stack[--this->stackPos];
+			break;
+		case CMD_REPT:
+		{
+			uint8_t count = this->Read8();
+			if (!count || ++this->repeatCount < count)
+				this->pos = this->Read32();
+			else
+			{
+				this->repeatCount = 0;
+				this->pos += 4;
+			}
+			break;
+		}
+		case CMD_MEMACC:
+			// Reads or writes the game's memory, which is no longer being emulated
+			this->pos += 3;
+			break;
+		case CMD_PRIO:
+			this->prio = this->Read8();
+			break;
+		case CMD_TEMPO:
+			this->mplay->SetTempo(this->Read8() * 2);
+			break;
+		case CMD_KEYSH:
+			this->keyShift = static_cast<int8_t>(this->Read8());
+			this->updateFlags.set(TUF_PITCH);
+			break;
+		case CMD_VOICE:
+			this->tone.Read(this->ply->memory, this->mplay->tone + this->Read8() * 12);
+			break;
+		case CMD_VOL:
+			this->vol = this->Read8();
+			this->updateFlags.set(TUF_VOL);
+			break;
+		case CMD_PAN:
+			this->pan = static_cast<int8_t>(this->Read8() - 0x40);
+			this->updateFlags.set(TUF_VOL);
+			break;
+		case CMD_BEND:
+			this->bend = static_cast<int8_t>(this->Read8() - 0x40);
+			this->updateFlags.set(TUF_PITCH);
+			break;
+		case CMD_BENDR:
+			this->bendRange = this->Read8();
+			this->updateFlags.set(TUF_PITCH);
+			break;
+		case CMD_LFOS:
+			this->lfoSpeed = this->Read8();
+			if (!this->lfoSpeed)
+				this->ClearModulation();
+			break;
+		case CMD_LFODL:
+			this->lfoDelay = this->Read8();
+			break;
+		case CMD_MOD:
+			this->mod = this->Read8();
+			if (!this->mod)
+				this->ClearModulation();
+			break;
+		case CMD_MODT:
+		{
+			uint8_t newModType = this->Read8();
+			if (newModType != this->modType)
+			{
+				this->ClearModulation();
+				this->modType = newModType;
+				this->updateFlags.set(TUF_VOL).set(TUF_PITCH);
+			}
+			break;
+		}
+		case CMD_TUNE:
+			this->tune = static_cast<int8_t>(this->Read8() - 0x40);
+			this->updateFlags.set(TUF_PITCH);
+			break;
+		case CMD_XCMD:
+			this->ExtendedCommand();
+			break;
+		case CMD_EOT:
+			this->EndTie();
+			break;
+		default:
+			// FINE, as well as the unused commands, which the engine also treats as the end of the track
+			this->Stop();
+	}
+}
+
+// Original engine function: MPlayMain, the part for a single track
+void Track::Run()
+{
+	this->ply->UpdateGateTimes(this);
+
+	int commands = 0;
+	while (!this->wait && this->active)
+	{
+		if (++commands > MaxCommandsPerTick)
+		{
+			this->Stop();
+			return;
+		}
+
+		uint8_t cmd = this->Peek8();
+		// Running status, the previous command is repeated with this byte as its first argument
+		if (cmd < 0x80)
+		{
+			cmd = this->runningStatus;
+			if (cmd < CMD_VOICE)
+			{
+				this->Stop();
+				return;
+			}
+		}
+		else
+		{
+			++this->pos;
+			if (cmd >= CMD_VOICE)
+				this->runningStatus = cmd;
+		}
+
+		if (cmd >= CMD_TIE)
+			this->Note(cmd);
+		else if (cmd < CMD_FINE)
+			this->wait = ClockTable[cmd - 0x80];
+		else
+			this->Command(cmd);
+	}
+	if (!this->active)
+		return;
+	--this->wait;
+
+	if (this->lfoSpeed && this->mod)
+	{
+		if (this->lfoDelayC)
+			--this->lfoDelayC;
+		else
+		{
+			this->lfoSpeedC += this->lfoSpeed;
+			int8_t triangle = static_cast<int8_t>(this->lfoSpeedC - 64) < 0 ? static_cast<int8_t>(this->lfoSpeedC) : static_cast<int8_t>(128 - this->lfoSpeedC);
+			auto newModM = static_cast<int8_t>((this->mod * triangle) >> 6);
+			if (newModM != this->modM)
+			{
+				this->modM = newModM;
+				this->updateFlags.set(this->modType ? TUF_VOL : TUF_PITCH);
+			}
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/*
+ * MP2K Player - Track structure
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ */
+
+#pragma once
+
+#include <bitset>
+#include "ToneData.h"
+#include "consts.h"
+
+struct MusicPlayer;
+struct Player;
+
+struct Track
+{
+	bool active;
+	MusicPlayer *mplay;
+	Player *ply;
+
+	uint32_t pos;
+	uint32_t stack[MP2K_PATTERNDEPTH];
+	uint8_t stackPos, repeatCount;
+	uint8_t runningStatus;
+
+	uint8_t wait;
+	uint8_t gateTime, key, velocity;
+	uint8_t prio;
+	ToneData tone;
+
+	uint8_t vol, volX;
+	int8_t pan; // -64..63
+	int8_t bend, tune, keyShift;
+	uint8_t bendRange;
+
+	uint8_t lfoSpeed, lfoSpeedC, lfoDelay, lfoDelayC, mod, modType;
+	int8_t modM;
+
+	uint8_t echoVolume, echoLength;
+
+	// Calculated from the above by UpdateVolPitch
+	uint8_t volMR, volML;
+	int8_t keyM;
+	uint8_t pitM;
+
+	std::bitset<TUF_BITS> updateFlags;
+
+	Track();
+
+	void Init(MusicPlayer *mplay, Player *ply, uint32_t dataPos);
+	void Zero();
+	void Stop();
+	void UpdateVolPitch();
+	void Run();
+
+private:
+	uint8_t Peek8() const;
+	uint8_t Read8();
+	uint32_t Read32();
+	void ClearModulation();
+	void Command(uint8_t cmd);
+	void ExtendedCommand();
+	void Note(uint8_t cmd);
+	void EndTie();
+};
@@ -0,0 +1,49 @@
+/*
+ * MP2K Player - Constants
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Values used by Nintendo's MusicPlayer2000 sound engine for the Game Boy
+ * Advance, also known as m4a or Sappy
+ */
+
+#pragma once
+
+#include <cstdint>
+
+const uint32_t GBA_CLOCK = 16777216;
+// The engine runs both its sequencer and its mixer once every VBlank, which comes every 228 lines of 1232 cycles each
+const uint32_t CyclesPerFrame = 228 * 1232;
+
+// The engine keeps a pointer to its SoundInfo structure at the end of IWRAM, and that structure and every
+// MusicPlayerInfo are marked with this once they are set up (or with this plus 1 while they are being worked on)
+const uint32_t SoundInfoPointerAddress = 0x03007FF0;
+const uint32_t MP2K_IDENT = 0x68736D53;
+
+const int MP2K_MAXPLAYERS = 32;
+const int MP2K_MAXTRACKS = 16;
+const int MP2K_MAXDSCHANNELS = 12;
+const int MP2K_CGBCHANNELS = 4;
+const int MP2K_PATTERNDEPTH = 3;
+const int MP2K_TEMPOBASE = 150;
+
+enum { CS_NONE, CS_ATTACK, CS_DECAY, CS_SUSTAIN, CS_RELEASE, CS_ECHO };
+
+enum { TUF_VOL, TUF_PITCH, TUF_BITS };
+
+enum
+{
+	TONE_DIRECTSOUND = 0x00,
+	TONE_CGBMASK = 0x07,
+	TONE_SQUARE1 = 0x01,
+	TONE_SQUARE2 = 0x02,
+	TONE_WAVE = 0x03,
+	TONE_NOISE = 0x04,
+	TONE_FIXED = 0x08,
+	TONE_REVERSE = 0x10,
+	TONE_KEYSPLIT = 0x40,
+	TONE_RHYTHM = 0x80
+};
+
+// Mutes, in the same order as the mutes for the emulated output, direct sound A is the right side and B is the left
+enum { MUTE_SQUARE1, MUTE_SQUARE2, MUTE_WAVE, MUTE_NOISE, MUTE_DSRIGHT, MUTE_DSLEFT, MUTE_BITS };
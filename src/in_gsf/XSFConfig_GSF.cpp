@@ -1,13 +1,13 @@
 /*
  * xSF - GSF configuration
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-24
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  */
 
 #include <bitset>
-#include "XSFPlayer.h"
+#include "XSFPlayer_GSF.h"
 #include "XSFConfig.h"
 #include "convert.h"
 #include "vbam/gba/Sound.h"
@@ -15,6 +15,7 @@
 enum
 {
 	idLowPassFiltering = 1000,
+	idMP2KHighLevelEmulation,
 	idMutes
 };
 
@@ -22,10 +23,12 @@ class XSFConfig_GSF : public XSFConfig
 {
 protected:
 	static bool initLowPassFiltering;
+	static bool initMP2KHighLevelEmulation;
 	static std::string initMutes;
 
 	friend class XSFConfig;
 	bool lowPassFiltering;
+	bool mp2kHighLevelEmulation;
 	std::bitset<6> mutes;
 
 	XSFConfig_GSF();
@@ -44,6 +47,7 @@ unsigned XSFConfig::initSampleRate = 44100;
 std::string XSFConfig::commonName = "GSF Decoder";
 std::string XSFConfig::versionNumber = "0.9b";
 bool XSFConfig_GSF::initLowPassFiltering = true;
+bool XSFConfig_GSF::initMP2KHighLevelEmulation = false;
 std::string XSFConfig_GSF::initMutes = "000000";
 
 XSFConfig *XSFConfig::Create()
@@ -51,7 +55,7 @@ XSFConfig *XSFConfig::Create()
 	return new XSFConfig_GSF();
 }
 
-XSFConfig_GSF::XSFConfig_GSF() : XSFConfig(), lowPassFiltering(false), mutes()
+XSFConfig_GSF::XSFConfig_GSF() : XSFConfig(), lowPassFiltering(false), mp2kHighLevelEmulation(false), mutes()
 {
 	this->supportedSampleRates.push_back(8000);
 	this->supportedSampleRates.push_back(11025);
@@ -69,6 +73,7 @@ XSFConfig_GSF::XSFConfig_GSF() : XSFConfig(), lowPassFiltering(false), mutes()
 void XSFConfig_GSF::LoadSpecificConfig()
 {
 	this->lowPassFiltering = this->configIO->GetValue("LowPassFiltering", XSFConfig_GSF::initLowPassFiltering);
+	this->mp2kHighLevelEmulation = this->configIO->GetValue("MP2KHighLevelEmulation", XSFConfig_GSF::initMP2KHighLevelEmulation);
 	std::stringstream mutesSS(this->configIO->GetValue("Mutes", XSFConfig_GSF::initMutes));
 	mutesSS >> this->mutes;
 }
@@ -76,6 +81,7 @@ void XSFConfig_GSF::LoadSpecificConfig()
 void XSFConfig_GSF::SaveSpecificConfig()
 {
 	this->configIO->SetValue("LowPassFiltering", this->lowPassFiltering);
+	this->configIO->SetValue("MP2KHighLevelEmulation", this->mp2kHighLevelEmulation);
 	this->configIO->SetValue("Mutes", this->mutes.to_string<char>());
 }
 
@@ -83,6 +89,8 @@ void XSFConfig_GSF::GenerateSpecificDialogs()
 {
 	this->configDialog.AddCheckBoxControl(DialogCheckBoxBuilder(L"Low-Pass Filtering").WithSize(80, 10).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 7), 2).WithTabStop().
 		WithID(idLowPassFiltering));
+	this->configDialog.AddCheckBoxControl(DialogCheckBoxBuilder(L"MP2K High-Level Emulation").WithSize(110, 10).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 7)).WithTabStop().
+		WithID(idMP2KHighLevelEmulation));
 	this->configDialog.AddLabelControl(DialogLabelBuilder(L"Mute").WithSize(50, 8).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 10)).IsLeftJustified());
 	this->configDialog.AddListBoxControl(DialogListBoxBuilder().WithSize(78, 45).WithExactHeight().InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_TOPRIGHT, Point<short>(5, -3)).WithID(idMutes).WithBorder().
 		WithVerticalScrollbar().WithMultipleSelect().WithTabStop());
@@ -96,6 +104,9 @@ INT_PTR CALLBACK XSFConfig_GSF::ConfigDialogProc(HWND hwndDlg, UINT uMsg, WPARAM
 			// Low-Pass Filtering
 			if (this->lowPassFiltering)
 				SendMessageW(GetDlgItem(hwndDlg, idLowPassFiltering), BM_SETCHECK, BST_CHECKED, 0);
+			// MP2K High-Level Emulation
+			if (this->mp2kHighLevelEmulation)
+				SendMessageW(GetDlgItem(hwndDlg, idMP2KHighLevelEmulation), BM_SETCHECK, BST_CHECKED, 0);
 			// Mutes
 			SendMessageW(GetDlgItem(hwndDlg, idMutes), LB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"Square 1"));
 			SendMessageW(GetDlgItem(hwndDlg, idMutes), LB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"Square 2"));
@@ -116,6 +127,7 @@ INT_PTR CALLBACK XSFConfig_GSF::ConfigDialogProc(HWND hwndDlg, UINT uMsg, WPARAM
 void XSFConfig_GSF::ResetSpecificConfigDefaults(HWND hwndDlg)
 {
 	SendMessageW(GetDlgItem(hwndDlg, idLowPassFiltering), BM_SETCHECK, XSFConfig_GSF::initLowPassFiltering ? BST_CHECKED : BST_UNCHECKED, 0);
+	SendMessageW(GetDlgItem(hwndDlg, idMP2KHighLevelEmulation), BM_SETCHECK, XSFConfig_GSF::initMP2KHighLevelEmulation ? BST_CHECKED : BST_UNCHECKED, 0);
 	auto tmpMutes = std::bitset<6>(XSFConfig_GSF::initMutes);
 	for (int x = 0, numMutes = tmpMutes.size(); x < numMutes; ++x)
 		SendMessageW(GetDlgItem(hwndDlg, idMutes), LB_SETSEL, tmpMutes[x], x);
@@ -124,22 +136,28 @@ void XSFConfig_GSF::ResetSpecificConfigDefaults(HWND hwndDlg)
 void XSFConfig_GSF::SaveSpecificConfigDialog(HWND hwndDlg)
 {
 	this->lowPassFiltering = SendMessageW(GetDlgItem(hwndDlg, idLowPassFiltering), BM_GETCHECK, 0, 0) == BST_CHECKED;
+	this->mp2kHighLevelEmulation = SendMessageW(GetDlgItem(hwndDlg, idMP2KHighLevelEmulation), BM_GETCHECK, 0, 0) == BST_CHECKED;
 	for (int x = 0, numMutes = this->mutes.size(); x < numMutes; ++x)
 		this->mutes[x] = !!SendMessageW(GetDlgItem(hwndDlg, idMutes), LB_GETSEL, x, 0);
 }
 
-void XSFConfig_GSF::CopySpecificConfigToMemory(XSFPlayer *, bool preLoad)
+void XSFConfig_GSF::CopySpecificConfigToMemory(XSFPlayer *xSFPlayer, bool preLoad)
 {
+	auto GSFPlayer = static_cast<XSFPlayer_GSF *>(xSFPlayer);
+	if (GSFPlayer)
+		GSFPlayer->SetMP2KHighLevelEmulation(this->mp2kHighLevelEmulation);
 	if (!preLoad)
 	{
 		soundInterpolation = this->lowPassFiltering;
 		unsigned long tmpMutes = this->mutes.to_ulong();
 		soundSetEnable((((tmpMutes & 0x30) << 4) | (tmpMutes & 0xF)) ^ 0x30F);
+		if (GSFPlayer)
+			GSFPlayer->SetMutes(this->mutes);
 	}
 }
 
 void XSFConfig_GSF::About(HWND parent)
 {
 	MessageBoxW(parent, ConvertFuncs::StringToWString(XSFConfig::commonName + " v" + XSFConfig::versionNumber + ", using xSF Winamp plugin framework (based on the vio*sf plugins) by Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]\n\n"
-		"Utilizes modified VBA-M, SVN revision 1231, for audio playback.").c_str(), ConvertFuncs::StringToWString(XSFConfig::commonName + " v" + XSFConfig::versionNumber).c_str(), MB_OK);
+		"Utilizes modified VBA-M, SVN revision 1231, for audio playback, or optionally a high-level emulation of the MP2K sound engine.").c_str(), ConvertFuncs::StringToWString(XSFConfig::commonName + " v" + XSFConfig::versionNumber).c_str(), MB_OK);
 }
@@ -1,7 +1,7 @@
 /*
  * xSF - GSF Player
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-24
+ * Last modification on 2026-10-19
  *
  * Based on a modified viogsf v0.08
  *
@@ -14,24 +14,10 @@
 #include <memory>
 #include <zlib.h>
 #include "convert.h"
-#include "XSFPlayer.h"
+#include "XSFPlayer_GSF.h"
 #include "XSFCommon.h"
 #include "vbam/gba/Globals.h"
 #include "vbam/gba/Sound.h"
-#include "vbam/common/SoundDriver.h"
-
-class XSFPlayer_GSF : public XSFPlayer
-{
-public:
-	XSFPlayer_GSF(const std::string &filename);
-#ifdef _WIN32
-	XSFPlayer_GSF(const std::wstring &filename);
-#endif
-	~XSFPlayer_GSF() { this->Terminate(); }
-	bool Load();
-	void GenerateSamples(std::vector<uint8_t> &buf, unsigned offset, unsigned samples);
-	void Terminate();
-};
 
 const char *XSFPlayer::WinampDescription = "GSF Decoder";
 const char *XSFPlayer::WinampExts = "gsf;minigsf\0Game Boy Advance Sound Format files (*.gsf;*.minigsf)\0";
@@ -64,62 +50,6 @@ int mapgsf(uint8_t *d, int l, int &s)
 	return l;
 }
 
-static struct
-{
-	std::vector<uint8_t> buf;
-	uint32_t len, fil, cur;
-} buffer = { std::vector<uint8_t>(), 0, 0, 0 };
-
-class GSFSoundDriver : public SoundDriver
-{
-	void freebuffer()
-	{
-		buffer.buf.clear();
-		buffer.len = buffer.fil = buffer.cur = 0;
-	}
-public:
-	bool init(long sampleRate)
-	{
-		freebuffer();
-		uint32_t len = (sampleRate / 10) << 2;
-		buffer.buf.resize(len);
-		buffer.len = len;
-		return true;
-	}
-
-	void pause()
-	{
-	}
-
-	void reset()
-	{
-	}
-
-	void resume()
-	{
-	}
-
-	void write(uint16_t *finalWave, int length)
-	{
-		if (static_cast<uint32_t>(length) > buffer.len - buffer.fil)
-			length = buffer.len - buffer.fil;
-		if (length > 0)
-		{
-			memcpy(&buffer.buf[buffer.fil], finalWave, length);
-			buffer.fil += length;
-		}
-	}
-
-	void setThrottle(unsigned short)
-	{
-	}
-};
-
-SoundDriver *systemSoundInit()
-{
-	return new GSFSoundDriver();
-}
-
 static void Map2SFSection(const std::vector<uint8_t> &section, int level)
 {
 	auto &data = loaderwork.rom;
@@ -150,12 +80,12 @@ static bool Map2SF(XSFFile *xSF, int level)
 
 static bool RecursiveLoad2SF(XSFFile *xSF, int level)
 {
-	if (level <= 10 && xSF->GetTagExists("_lib"))
+	if (level <= 10 && xSF->GetTagExists(WellKnownTags::Lib))
 	{
 #ifdef _WIN32
-		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSF->GetFilename()) + xSF->GetTagValue("_lib")), 8, 12));
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(WellKnownTags::Lib))), 8, 12));
 #else
-		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSF->GetFilename()) + xSF->GetTagValue("_lib"), 8, 12));
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(WellKnownTags::Lib)), 8, 12));
 #endif
 		if (!RecursiveLoad2SF(libxSF.get(), level + 1))
 			return false;
@@ -174,9 +104,9 @@ static bool RecursiveLoad2SF(XSFFile *xSF, int level)
 		{
 			found = true;
 #ifdef _WIN32
-			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSF->GetFilename()) + xSF->GetTagValue(libTag)), 8, 12));
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(libTag))), 8, 12));
 #else
-			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSF->GetFilename()) + xSF->GetTagValue(libTag), 8, 12));
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(libTag)), 8, 12));
 #endif
 			if (!RecursiveLoad2SF(libxSF.get(), level + 1))
 				return false;
@@ -194,13 +124,13 @@ static bool Load2SF(XSFFile *xSF)
 	return RecursiveLoad2SF(xSF, 1);
 }
 
-XSFPlayer_GSF::XSFPlayer_GSF(const std::string &filename) : XSFPlayer()
+XSFPlayer_GSF::XSFPlayer_GSF(const std::string &filename) : XSFPlayer(), mp2kPlayer(), useMP2KHighLevelEmulation(false), playingMP2K(false)
 {
 	this->xSF.reset(new XSFFile(filename, 8, 12));
 }
 
 #ifdef _WIN32
-XSFPlayer_GSF::XSFPlayer_GSF(const std::wstring &filename) : XSFPlayer()
+XSFPlayer_GSF::XSFPlayer_GSF(const std::wstring &filename) : XSFPlayer(), mp2kPlayer(), useMP2KHighLevelEmulation(false), playingMP2K(false)
 {
 	this->xSF.reset(new XSFFile(filename, 8, 12));
 }
@@ -213,39 +143,69 @@ bool XSFPlayer_GSF::Load()
 
 	cpuIsMultiBoot = (loaderwork.entry >> 24) == 2;
 
-	CPULoadRom();
+	int romSize = CPULoadRom();
 
 	soundSetSampleRate(this->sampleRate);
-	soundInit();
 	soundReset();
 	soundSetEnable(0x30F);
 
 	CPUInit();
 	CPUReset();
 
+	this->playingMP2K = this->useMP2KHighLevelEmulation && this->StartMP2K(romSize);
+
 	return XSFPlayer::Load();
 }
 
+// How long the game is given to start a song with its sound engine, most start one right away
+static const unsigned MP2KStartCycles = GBA_CLOCK * 2;
+
+// Lets the game run until its sound engine has started the song, and then takes the song over from the engine.
+// If the game doesn't use the engine, the emulation is started over so the song still plays from its beginning.
+bool XSFPlayer_GSF::StartMP2K(int romSize)
+{
+	GBAMemory memory;
+	memory.ewram = workRAM;
+	memory.iwram = internalRAM;
+	if (!cpuIsMultiBoot)
+	{
+		memory.rom = rom;
+		memory.romSize = romSize;
+	}
+
+	for (unsigned cycles = 0; cycles < MP2KStartCycles; cycles += SOUND_CLOCK_TICKS)
+	{
+		CPULoop(soundTicks);
+		soundDiscardSamples();
+		if (this->mp2kPlayer.Setup(memory, this->sampleRate))
+			return true;
+	}
+
+	CPULoadRom();
+	soundReset();
+	CPUInit();
+	CPUReset();
+	return false;
+}
+
 void XSFPlayer_GSF::GenerateSamples(std::vector<uint8_t> &buf, unsigned offset, unsigned samples)
 {
-	unsigned bytes = samples << 2;
-	while (bytes)
+	if (this->playingMP2K)
 	{
-		unsigned remainbytes = buffer.fil - buffer.cur;
-		while (!remainbytes)
-		{
-			buffer.cur = buffer.fil = 0;
-			CPULoop(250000);
+		this->mp2kPlayer.GenerateSamples(buf, offset, samples);
+		return;
+	}
 
-			remainbytes = buffer.fil - buffer.cur;
-		}
-		unsigned len = remainbytes;
-		if (len > bytes)
-			len = bytes;
-		memcpy(&buf[offset], &buffer.buf[buffer.cur], len);
-		bytes -= len;
-		offset += len;
-		buffer.cur += len;
+	// The emulation is run a sound frame at a time, only for as long as it takes to have the samples asked for, and the samples are
+	// read straight into buf
+	auto out = reinterpret_cast<int16_t *>(&buf[offset]);
+	while (samples)
+	{
+		if (!soundSamplesAvailable())
+			CPULoop(soundTicks);
+		long read = soundReadSamples(out, samples);
+		out += read << 1;
+		samples -= read;
 	}
 }
 
@@ -255,4 +215,16 @@ void XSFPlayer_GSF::Terminate()
 
 	loaderwork.rom.clear();
 	loaderwork.entry = 0;
+
+	this->playingMP2K = false;
+}
+
+void XSFPlayer_GSF::SetMP2KHighLevelEmulation(bool enabled)
+{
+	this->useMP2KHighLevelEmulation = enabled;
+}
+
+void XSFPlayer_GSF::SetMutes(const std::bitset<6> &newMutes)
+{
+	this->mp2kPlayer.mutes = newMutes;
 }
@@ -1,11 +1,18 @@
 // Blip_Buffer 0.4.1. http://www.slack.net/~ant/
 
+#include <algorithm>
 #include <limits>
 #include <numeric>
 #include <cmath>
 #include <cstring>
 #include "Blip_Buffer.h"
 #include "XSFCommon.h"
+#ifdef BLIP_BUFFER_AVX2
+# include <immintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
 
 /* Copyright (C) 2003-2007 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -167,8 +174,45 @@ void Blip_Synth_Fast_::volume_unit(double new_unit)
 	this->delta_factor = static_cast<int>(new_unit * (1L << blip_sample_bits) + 0.5);
 }
 
+#ifdef BLIP_BUFFER_AVX2
+static bool blip_cpu_has_avx2()
+{
+# ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	// The OS has to save the AVX registers as well as the CPU having them
+	if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return !!(info[1] & 0x20);
+# else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+# endif
+}
+
+const bool blip_use_avx2_ = blip_cpu_has_avx2();
+
+# ifdef __GNUC__
+__attribute__((target("avx2")))
+# endif
+void blip_add_kernel_avx2_(int32_t *buf, const int32_t *kernel, int32_t delta)
+{
+	__m256i d = _mm256_set1_epi32(delta);
+	for (int i = 0; i < blip_widest_impulse_; i += 8)
+	{
+		__m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&kernel[i]));
+		auto out = reinterpret_cast<__m256i *>(&buf[i]);
+		_mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), _mm256_mullo_epi32(k, d)));
+	}
+}
+#endif
+
 #ifndef BLIP_BUFFER_FAST
-Blip_Synth_::Blip_Synth_(short *p, int w) : impulses(p), width(w)
+Blip_Synth_::Blip_Synth_(short *p, int32_t *k, int w) : impulses(p), kernels(k), width(w)
 {
 	this->volume_unit_ = 0.0;
 	this->kernel_unit = 0;
@@ -250,6 +294,23 @@ void Blip_Synth_::adjust_impulse()
 			//printf("%5ld,", this->impulses[j * blip_res + i + 1]);
 }
 
+// Only half of each impulse is kept, the first half is read forwards from the phase's mirror and the second half backwards from the phase
+void Blip_Synth_::make_kernels()
+{
+	int fwd = (blip_widest_impulse_ - this->width) / 2;
+	int half = this->width / 2;
+	for (int phase = 0; phase < blip_res; ++phase)
+	{
+		auto kernel = &this->kernels[phase * blip_widest_impulse_];
+		std::fill_n(kernel, blip_widest_impulse_, 0);
+		for (int i = 0; i < half; ++i)
+		{
+			kernel[fwd + i] = this->impulses[blip_res - phase + blip_res * i];
+			kernel[fwd + this->width - 1 - i] = this->impulses[phase + blip_res * i];
+		}
+	}
+}
+
 void Blip_Synth_::treble_eq(const blip_eq_t &eq)
 {
 	float fimpulse[blip_res / 2 * (blip_widest_impulse_ - 1) + blip_res * 2];
@@ -286,6 +347,7 @@ void Blip_Synth_::treble_eq(const blip_eq_t &eq)
 		next += fimpulse[i + blip_res];
 	}
 	this->adjust_impulse();
+	this->make_kernels();
 
 	// volume might require rescaling
 	double vol = this->volume_unit_;
@@ -330,6 +392,7 @@ void Blip_Synth_::volume_unit(double new_unit)
 				for (int i = this->impulses_size(); i--; )
 					this->impulses[i] = static_cast<short>(((this->impulses[i] + offset) >> shift) - offset2);
 				this->adjust_impulse();
+				this->make_kernels();
 			}
 		}
 		this->delta_factor = static_cast<int>(std::floor(factor + 0.5));
@@ -6,6 +6,15 @@
 #include <vector>
 #include <cstdint>
 
+// The synthesis uses SSE2 where the compiler can always use it, and AVX2 as well when the CPU running it turns out to have it
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define BLIP_BUFFER_SSE2
+# include <emmintrin.h>
+# if defined(__GNUC__) || defined(_MSC_VER)
+#  define BLIP_BUFFER_AVX2
+# endif
+#endif
+
 // Time unit at source clock rate
 typedef int32_t blip_time_t;
 
@@ -157,17 +166,52 @@ public:
 	int delta_factor;
 
 	void volume_unit(double);
-	Blip_Synth_(short *impulses, int width);
+	Blip_Synth_(short *impulses, int32_t *kernels, int width);
 	void treble_eq(const blip_eq_t &);
 private:
 	double volume_unit_;
 	short *const impulses;
+	int32_t *const kernels;
 	const int width;
 	int32_t kernel_unit;
 	int impulses_size() const { return blip_res / 2 * this->width + 1; }
 	void adjust_impulse();
+	void make_kernels();
 };
 
+// Adds a whole impulse, the blip_widest_impulse_ values of a kernel times delta, into buf
+#ifdef BLIP_BUFFER_AVX2
+extern const bool blip_use_avx2_;
+void blip_add_kernel_avx2_(int32_t *buf, const int32_t *kernel, int32_t delta);
+#endif
+
+inline void blip_add_kernel_(int32_t *buf, const int32_t *kernel, int32_t delta)
+{
+#ifdef BLIP_BUFFER_AVX2
+	if (blip_use_avx2_)
+	{
+		blip_add_kernel_avx2_(buf, kernel, delta);
+		return;
+	}
+#endif
+#ifdef BLIP_BUFFER_SSE2
+	// SSE2 only multiplies pairs of 32-bit values into 64-bit results, the low halves of which are the same as the wrapped products
+	__m128i d = _mm_set1_epi32(delta);
+	for (int i = 0; i < blip_widest_impulse_; i += 4)
+	{
+		__m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&kernel[i]));
+		__m128i even = _mm_mul_epu32(k, d);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(k, 32), d);
+		__m128i product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		auto out = reinterpret_cast<__m128i *>(&buf[i]);
+		_mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), product));
+	}
+#else
+	for (int i = 0; i < blip_widest_impulse_; ++i)
+		buf[i] += kernel[i] * delta;
+#endif
+}
+
 // Quality level, better = slower. In general, use blip_good_quality.
 enum
 {
@@ -224,8 +268,10 @@ private:
 	Blip_Synth_ impl;
 	typedef int16_t imp_t;
 	imp_t impulses[blip_res * (quality / 2) + 1];
+	// The impulses laid out whole for each phase, padded with 0 to blip_widest_impulse_ so all qualities add the same way
+	int32_t kernels[blip_res * blip_widest_impulse_];
 public:
-	Blip_Synth() : impl(impulses, quality) { }
+	Blip_Synth() : impl(impulses, kernels, quality) { }
 #endif
 };
 
@@ -329,80 +375,7 @@ template<int quality, int range> inline void Blip_Synth<quality, range>::offset_
 	buf[0] = left;
 	buf[1] = right;
 #else
-	int fwd = (blip_widest_impulse_ - quality) / 2;
-	int rev = fwd + quality - 2;
-	int mid = quality / 2 - 1;
-
-	auto imp = &this->impulses[blip_res - phase];
-
-# if defined(_M_IX86) || defined(_M_IA64) || defined(__i486__) || defined(__x86_64__) || defined(__ia64__) || defined(__i386__)
-	// this straight forward version gave in better code on GCC for x86
-
-	auto ADD_IMP = [&](int out, int in) { buf[out] += static_cast<int32_t>(imp[blip_res * in]) * delta; };
-
-	auto BLIP_FWD = [&](int i) { ADD_IMP(fwd + i, i); ADD_IMP(fwd + 1 + i, i + 1); };
-	auto BLIP_REV = [&](int r) { ADD_IMP(rev - r, r + 1); ADD_IMP(rev + 1 - r, r); };
-
-	BLIP_FWD(0);
-	if (quality > 8)
-		BLIP_FWD(2);
-	if (quality > 12)
-		BLIP_FWD(4);
-	ADD_IMP(fwd + mid - 1, mid - 1);
-	ADD_IMP(fwd + mid, mid);
-	imp = &this->impulses[phase];
-	if (quality > 12)
-		BLIP_REV(6);
-	if (quality > 8)
-		BLIP_REV(4);
-	BLIP_REV(2);
-
-	ADD_IMP(rev, 1);
-	ADD_IMP(rev + 1, 0);
-# else
-	// for RISC processors, help compiler by reading ahead of writes
-
-	int32_t i0 = *imp;
-
-	auto BLIP_FWD = [&](int i)
-	{
-		int32_t t0 = i0 * delta + buf[fwd + i];
-		int32_t t1 = imp[blip_res * (i + 1)] * delta + buf[fwd + 1 + i];
-		i0 = imp[blip_res * (i + 2)];
-		buf[fwd + i] = t0;
-		buf[fwd + 1 + i] = t1;
-	};
-	auto BLIP_REV = [&](int r)
-	{
-		int32_t t0 = i0 * delta + buf[rev - r];
-		int32_t t1 = imp[blip_res * r] * delta + buf[rev + 1 - r];
-		i0 = imp[blip_res * (r - 1)];
-		buf[rev - r] = t0;
-		buf[rev + 1 - r] = t1;
-	};
-
-	BLIP_FWD(0);
-	if (quality > 8)
-		BLIP_FWD(2);
-	if (quality > 12)
-		BLIP_FWD(4);
-	int32_t t0 = i0 * delta + buf[fwd + mid - 1];
-	int32_t t1 = imp[blip_res * mid] * delta + buf[fwd + mid];
-	imp = &this->impulses[phase];
-	i0 = imp[blip_res * mid];
-	buf[fwd + mid - 1] = t0;
-	buf[fwd + mid] = t1;
-	if (quality > 12)
-		BLIP_REV(6);
-	if (quality > 8)
-		BLIP_REV(4);
-	BLIP_REV(2);
-
-	t0 = i0 * delta + buf[rev];
-	t1 = *imp * delta + buf[rev + 1];
-	buf[rev] = t0;
-	buf[rev + 1] = t1;
-# endif
+	blip_add_kernel_(buf, &this->kernels[phase * blip_widest_impulse_], delta);
 #endif
 }
 
@@ -194,6 +194,29 @@ void Stereo_Mixer::mix_mono(blip_sample_t *out_, int count)
 
 void Stereo_Mixer::mix_stereo(blip_sample_t *out_, int count)
 {
+#ifdef BLIP_BUFFER_SSE2
+	// Left, right and center are run through the integrator together, with center twice so it can be added to both sides at once.
+	// Packing with signed saturation clamps the same as BLIP_CLAMP, the samples are far from the range where the two differ.
+	int start = this->samples_read - count;
+	auto left = &this->bufs[0]->buffer_[start];
+	auto right = &this->bufs[1]->buffer_[start];
+	auto center = &this->bufs[2]->buffer_[start];
+	__m128i bass = _mm_cvtsi32_si128(BLIP_READER_BASS(this->bufs[2]));
+	__m128i accum = _mm_set_epi32(this->bufs[2]->reader_accum_, this->bufs[2]->reader_accum_, this->bufs[1]->reader_accum_,
+		this->bufs[0]->reader_accum_);
+	auto out = reinterpret_cast<int32_t *>(out_);
+	for (int i = 0; i < count; ++i)
+	{
+		__m128i s = _mm_add_epi32(accum, _mm_shuffle_epi32(accum, _MM_SHUFFLE(1, 0, 3, 2)));
+		s = _mm_srai_epi32(s, blip_sample_bits - 16);
+		out[i] = _mm_cvtsi128_si32(_mm_packs_epi32(s, s));
+		accum = _mm_sub_epi32(accum, _mm_sra_epi32(accum, bass));
+		accum = _mm_add_epi32(accum, _mm_set_epi32(center[i], center[i], right[i], left[i]));
+	}
+	this->bufs[0]->reader_accum_ = _mm_cvtsi128_si32(accum);
+	this->bufs[1]->reader_accum_ = _mm_cvtsi128_si32(_mm_shuffle_epi32(accum, _MM_SHUFFLE(1, 1, 1, 1)));
+	this->bufs[2]->reader_accum_ = _mm_cvtsi128_si32(_mm_shuffle_epi32(accum, _MM_SHUFFLE(2, 2, 2, 2)));
+#else
 	auto out = &out_[count * stereo];
 
 	// do left + center and right + center separately to reduce register load
@@ -232,4 +255,5 @@ void Stereo_Mixer::mix_stereo(blip_sample_t *out_, int count)
 		BLIP_READER_END(center, *this->bufs[2]);
 		break;
 	}
+#endif
 }
@@ -2170,6 +2170,8 @@ int armExecute()
 		if (!clockTicks)
 			clockTicks = 1 + codeTicksAccessSeq32(oldArmNextPC);
 		cpuTotalTicks += clockTicks;
+		if (UNLIKELY(armNextPC <= static_cast<uint32_t>(oldArmNextPC)))
+			CPUCheckIdleLoop();
 	} while (cpuTotalTicks < cpuNextEvent && armState && !holdState && !SWITicks);
 
 	return 1;
@@ -1581,6 +1581,8 @@ int thumbExecute()
 		if (!clockTicks)
 			clockTicks = codeTicksAccessSeq16(oldArmNextPC) + 1;
 		cpuTotalTicks += clockTicks;
+		if (UNLIKELY(armNextPC <= oldArmNextPC))
+			CPUCheckIdleLoop();
 	} while (cpuTotalTicks < cpuNextEvent && !armState && !holdState && !SWITicks);
 	return 1;
 }
@@ -31,6 +31,11 @@ uint32_t cpuPrefetch[2];
 
 int cpuTotalTicks = 0;
 
+// The CPU loop's events are kept as the times they fall due on this clock, which the loop moves forward by the ticks of each step instead
+// of counting every event down, so an event's time only changes when it is handled or reprogrammed.  The clock is brought back to 0
+// whenever CPULoop returns, so outside of the loop the times are the same as ticks from now.
+int cpuEventTime = 0;
+
 static int lcdTicks = 208;
 static uint8_t timerOnOffDelay = 0;
 static uint16_t timer0Value = 0;
@@ -267,6 +272,9 @@ static uint32_t myROM[] =
 };
 
 static int romSize = 0x2000000;
+uint32_t romOpenBusStart = 0x2000000;
+// How much of rom the last image was written to
+static uint32_t romWrittenEnd = 0;
 
 static inline int CPUUpdateTicks()
 {
@@ -284,6 +292,8 @@ static inline int CPUUpdateTicks()
 	if (timer3On && !(TM3CNT & 4) && timer3Ticks < cpuLoopTicks)
 		cpuLoopTicks = timer3Ticks;
 
+	cpuLoopTicks -= cpuEventTime;
+
 	if (SWITicks && SWITicks < cpuLoopTicks)
 		cpuLoopTicks = SWITicks;
 
@@ -293,24 +303,51 @@ static inline int CPUUpdateTicks()
 	return cpuLoopTicks;
 }
 
+// Work RAM and internal RAM are mirrored throughout their areas, rom only maps the pages that lie wholly within the image, as past it
+// reads have to be worked out by CPUReadRomHalfWord
+static void CPUMapPages()
+{
+	for (uint32_t i = 0; i < CPU_PAGE_COUNT; ++i)
+	{
+		uint32_t address = i << CPU_PAGE_SHIFT;
+		uint8_t *page = nullptr;
+		switch (address >> 24)
+		{
+			case 2:
+				page = &workRAM[address & 0x3FFFF];
+				break;
+			case 3:
+				page = &internalRAM[address & 0x7FFF];
+		}
+		cpuWritePages[i] = page;
+		if ((address >> 24) >= 8 && (address >> 24) <= 12 && (address & 0x1FFFFFF) + CPU_PAGE_MASK < romOpenBusStart)
+			page = &rom[address & 0x1FFFFFF];
+		cpuReadPages[i] = page;
+	}
+}
+
+// Only the part of rom covered by the image is written to, reads past it are worked out by CPUReadRomHalfWord instead, so pages of
+// rom that a set never uses are never touched.
 int CPULoadRom()
 {
 	romSize = 0x2000000;
 
-	memset(&rom[0], 0, 0x2000000);
 	memset(&workRAM[0], 0, 0x40000);
 
+	uint32_t imageEnd = 0;
 	if (cpuIsMultiBoot)
 		mapgsf(&workRAM[0], 0x40000, romSize);
 	else
-		mapgsf(&rom[0], 0x2000000, romSize);
-
-	auto temp = reinterpret_cast<uint16_t *>(&rom[(romSize + 1) & ~1]);
-	for (int i = (romSize + 1) & ~1; i < 0x2000000; i += 2)
 	{
-		WRITE16LE(&temp[0], (i >> 1) & 0xFFFF);
-		++temp;
+		mapgsf(&rom[0], 0x2000000, romSize);
+		imageEnd = romSize;
 	}
+	romOpenBusStart = (romSize + 1) & ~1;
+
+	// Whatever an earlier, larger image left behind is cleared, nothing reads it but it keeps rom the same as for a fresh load
+	if (romWrittenEnd > imageEnd)
+		memset(&rom[imageEnd], 0, romWrittenEnd - imageEnd);
+	romWrittenEnd = imageEnd;
 
 	memset(&bios[0], 0, 0x4000);
 	memset(&internalRAM[0], 0, 0x8000);
@@ -496,6 +533,9 @@ void CPUSoftwareInterrupt()
 
 void CPUSoftwareInterrupt(int comment)
 {
+	// The BIOS calls are worked out here rather than run, so the idle loop detection can't see what they touch
+	cpuIdleLoopBroken = true;
+
 	if (armState)
 		comment >>= 16;
 	if (comment == 0xfa)
@@ -649,10 +689,7 @@ void CPUSoftwareInterrupt(int comment)
 			BIOS_Diff16bitUnFilter();
 			break;
 		case 0x19:
-			if (reg[0].I)
-				soundPause();
-			else
-				soundResume();
+			// SoundBias, the bias level has no effect on the output
 			break;
 		case 0x1F:
 			BIOS_MidiKey2Freq();
@@ -689,6 +726,98 @@ static void CPUCompareVCOUNT()
 	}
 }
 
+// The memory a DMA can go through directly instead of unit by unit through CPUReadMemory and CPUWriteMemory: the work RAMs and, as a
+// source, the part of rom covered by the image.  None of it has side effects on access.  Returns nullptr if any unit of the transfer
+// falls outside of such memory, otherwise the memory with mask set to what addresses in it are masked by.
+static uint8_t *CPUDMADirectMemory(uint32_t start, uint32_t inc, uint32_t count, uint32_t unit, bool source, uint32_t &mask)
+{
+	// A transfer covers at most 0x10000 units of 4 bytes, so it stays in one 16 MB area as long as its first and last units do
+	uint32_t end = start + inc * (count - 1);
+	if ((start >> 24) != (end >> 24))
+		return nullptr;
+	switch (start >> 24)
+	{
+		case 2:
+			mask = 0x3FFFF & ~(unit - 1);
+			return workRAM;
+		case 3:
+			mask = 0x7FFF & ~(unit - 1);
+			return internalRAM;
+		case 8:
+		case 9:
+		case 10:
+		case 11:
+		case 12:
+		{
+			if (!source)
+				return nullptr;
+			uint32_t low = std::min(start, end) & 0x1FFFFFF, high = std::max(start, end) & 0x1FFFFFF;
+			if (high + unit > romOpenBusStart)
+				return nullptr;
+			// CPUReadHalfWord returns 0 for the GPIO registers instead of what is in rom
+			if (unit == 2 && (start >> 24) == 8 && low <= 0xC8 && high >= 0xC4)
+				return nullptr;
+			mask = 0x1FFFFFF & ~(unit - 1);
+			return rom;
+		}
+	}
+	return nullptr;
+}
+
+// Copies between the memory CPUDMADirectMemory gives, the same as the regular transfer would unit by unit.  When both sides step up by
+// a unit at a time without wrapping around their mirrors and without overlapping, it is just a memcpy.
+static bool doDMADirect(uint32_t &s, uint32_t &d, uint32_t si, uint32_t di, uint32_t c, uint32_t unit)
+{
+	uint32_t sourceMask, destMask;
+	auto source = CPUDMADirectMemory(s, si, c, unit, true, sourceMask);
+	if (!source)
+		return false;
+	auto dest = CPUDMADirectMemory(d, di, c, unit, false, destMask);
+	if (!dest)
+		return false;
+
+	uint32_t sourceOffset = s & sourceMask, destOffset = d & destMask, size = c * unit;
+	if (si == unit && di == unit && sourceOffset + size <= sourceMask + unit && destOffset + size <= destMask + unit &&
+		(source != dest || sourceOffset + size <= destOffset || destOffset + size <= sourceOffset))
+	{
+		memcpy(&dest[destOffset], &source[sourceOffset], size);
+		if (unit == 4)
+			cpuDmaLast = READ32LE(&source[sourceOffset + size - 4]);
+		else
+		{
+			cpuDmaLast = READ16LE(&source[sourceOffset + size - 2]);
+			cpuDmaLast |= cpuDmaLast << 16;
+		}
+		s += size;
+		d += size;
+	}
+	else if (unit == 4)
+	{
+		while (c)
+		{
+			cpuDmaLast = READ32LE(&source[s & sourceMask]);
+			WRITE32LE(&dest[d & destMask], cpuDmaLast);
+			d += di;
+			s += si;
+			--c;
+		}
+	}
+	else
+	{
+		while (c)
+		{
+			cpuDmaLast = READ16LE(&source[s & sourceMask]);
+			WRITE16LE(&dest[d & destMask], cpuDmaLast);
+			cpuDmaLast |= cpuDmaLast << 16;
+			d += di;
+			s += si;
+			--c;
+		}
+	}
+	cpuIdleLoopBroken = true;
+	return true;
+}
+
 static void doDMA(uint32_t &s, uint32_t &d, uint32_t si, uint32_t di, uint32_t c, int transfer32)
 {
 	int sm = s >> 24;
@@ -719,7 +848,7 @@ static void doDMA(uint32_t &s, uint32_t &d, uint32_t si, uint32_t di, uint32_t c
 				--c;
 			}
 		}
-		else
+		else if (!doDMADirect(s, d, si, di, c, 4))
 		{
 			while (c)
 			{
@@ -745,7 +874,7 @@ static void doDMA(uint32_t &s, uint32_t &d, uint32_t si, uint32_t di, uint32_t c
 				--c;
 			}
 		}
-		else
+		else if (!doDMADirect(s, d, si, di, c, 2))
 		{
 			while (c)
 			{
@@ -1421,7 +1550,7 @@ static void applyTimer()
 		{
 			// reload the counter
 			TM0D = timer0Reload;
-			timer0Ticks = (0x10000 - TM0D) << timer0ClockReload;
+			timer0Ticks = cpuEventTime + ((0x10000 - TM0D) << timer0ClockReload);
 			UPDATE_REG(0x100, TM0D);
 		}
 		timer0On = !!(timer0Value & 0x80);
@@ -1436,7 +1565,7 @@ static void applyTimer()
 		{
 			// reload the counter
 			TM1D = timer1Reload;
-			timer1Ticks = (0x10000 - TM1D) << timer1ClockReload;
+			timer1Ticks = cpuEventTime + ((0x10000 - TM1D) << timer1ClockReload);
 			UPDATE_REG(0x104, TM1D);
 		}
 		timer1On = !!(timer1Value & 0x80);
@@ -1450,7 +1579,7 @@ static void applyTimer()
 		{
 			// reload the counter
 			TM2D = timer2Reload;
-			timer2Ticks = (0x10000 - TM2D) << timer2ClockReload;
+			timer2Ticks = cpuEventTime + ((0x10000 - TM2D) << timer2ClockReload);
 			UPDATE_REG(0x108, TM2D);
 		}
 		timer2On = !!(timer2Value & 0x80);
@@ -1464,7 +1593,7 @@ static void applyTimer()
 		{
 			// reload the counter
 			TM3D = timer3Reload;
-			timer3Ticks = (0x10000 - TM3D) << timer3ClockReload;
+			timer3Ticks = cpuEventTime + ((0x10000 - TM3D) << timer3ClockReload);
 			UPDATE_REG(0x10C, TM3D);
 		}
 		timer3On = !!(timer3Value & 0x80);
@@ -1522,7 +1651,7 @@ void CPUInit()
 	std::fill(&ioReadable[0x20c], &ioReadable[0x300], false);
 	std::fill(&ioReadable[0x304], &ioReadable[0x400], false);
 
-	if (romSize < 0x1fe2000)
+	if (romOpenBusStart < 0x1fe2000)
 	{
 		*reinterpret_cast<uint16_t *>(&rom[0x1fe209c]) = 0xdffa; // SWI 0xFA
 		*reinterpret_cast<uint16_t *>(&rom[0x1fe209e]) = 0x4770; // BX LR
@@ -1655,6 +1784,7 @@ void CPUReset()
 	biosProtected[2] = 0x29;
 	biosProtected[3] = 0xe1;
 
+	cpuEventTime = 0;
 	lcdTicks = 208;
 	timer0On = false;
 	timer0Ticks = 0;
@@ -1711,6 +1841,8 @@ void CPUReset()
 	map[12].address = &rom[0];
 	map[12].mask = 0x1FFFFFF;
 
+	CPUMapPages();
+
 	soundReset();
 
 	// make sure registers are correctly initialized if not using BIOS
@@ -1723,6 +1855,88 @@ void CPUReset()
 	SWITicks = 0;
 }
 
+// Idle loops ///////////////////////////////////////////////////////////////
+
+// Drivers spend much of their time spinning on VCOUNT, IF or a flag in RAM that an interrupt sets.  Nothing such a loop reads can
+// change until the next event, so once a whole pass of it is seen to leave the CPU exactly as it found it, without writing to memory
+// or reading a running timer, every pass until the event would do the same, and the time they would take is added without running
+// them.  Only whole passes that end before the event are skipped, the rest is run as normal so the event finds the CPU in the same
+// place it always would.
+bool cpuIdleLoopBroken = false;
+static bool idleLoopWatching = false;
+static bool idleLoopHasState = false;
+static uint32_t idleLoopPC = 0;
+static int idleLoopTicks = 0;
+static struct
+{
+	reg_pair reg[45];
+	uint32_t armNextPC;
+	uint32_t cpuPrefetch[2];
+	uint32_t busPrefetchCount;
+	int armMode;
+	bool N_FLAG, Z_FLAG, C_FLAG, V_FLAG, armState, armIrqEnable, busPrefetch;
+} idleLoopState;
+
+static void CPUSaveIdleLoopState()
+{
+	std::copy_n(&reg[0], 45, &idleLoopState.reg[0]);
+	idleLoopState.armNextPC = armNextPC;
+	std::copy_n(&cpuPrefetch[0], 2, &idleLoopState.cpuPrefetch[0]);
+	idleLoopState.busPrefetchCount = busPrefetchCount;
+	idleLoopState.armMode = armMode;
+	idleLoopState.N_FLAG = N_FLAG;
+	idleLoopState.Z_FLAG = Z_FLAG;
+	idleLoopState.C_FLAG = C_FLAG;
+	idleLoopState.V_FLAG = V_FLAG;
+	idleLoopState.armState = armState;
+	idleLoopState.armIrqEnable = armIrqEnable;
+	idleLoopState.busPrefetch = busPrefetch;
+}
+
+static bool CPUIdleLoopStateMatches()
+{
+	for (int i = 0; i < 45; ++i)
+		if (reg[i].I != idleLoopState.reg[i].I)
+			return false;
+	return armNextPC == idleLoopState.armNextPC && cpuPrefetch[0] == idleLoopState.cpuPrefetch[0] && cpuPrefetch[1] == idleLoopState.cpuPrefetch[1] &&
+		busPrefetchCount == idleLoopState.busPrefetchCount && armMode == idleLoopState.armMode && N_FLAG == idleLoopState.N_FLAG &&
+		Z_FLAG == idleLoopState.Z_FLAG && C_FLAG == idleLoopState.C_FLAG && V_FLAG == idleLoopState.V_FLAG && armState == idleLoopState.armState &&
+		armIrqEnable == idleLoopState.armIrqEnable && busPrefetch == idleLoopState.busPrefetch;
+}
+
+// Called by the execution loops after a jump backwards, with armNextPC at the instruction jumped to.  The first such target after an
+// event is watched: the next time it is reached, the state of the CPU is kept, and the time after that, if nothing broke the loop
+// in between, the passes up to the event are skipped.
+void CPUCheckIdleLoop()
+{
+	if (idleLoopWatching && !cpuIdleLoopBroken)
+	{
+		if (armNextPC == idleLoopPC)
+		{
+			if (idleLoopHasState && CPUIdleLoopStateMatches())
+			{
+				int passTicks = cpuTotalTicks - idleLoopTicks;
+				if (passTicks > 0 && cpuTotalTicks < cpuNextEvent)
+					cpuTotalTicks += (cpuNextEvent - 1 - cpuTotalTicks) / passTicks * passTicks;
+			}
+			else
+			{
+				CPUSaveIdleLoopState();
+				idleLoopHasState = true;
+			}
+			idleLoopTicks = cpuTotalTicks;
+			return;
+		}
+		// A jump back from within the loop being watched, such as the return from a subroutine it calls
+		if (idleLoopHasState)
+			return;
+	}
+	idleLoopWatching = true;
+	idleLoopHasState = false;
+	idleLoopPC = armNextPC;
+	cpuIdleLoopBroken = false;
+}
+
 static void CPUInterrupt()
 {
 	uint32_t PC = reg[15].I;
@@ -1761,15 +1975,16 @@ void CPULoop(int ticks)
 	{
 		if (!holdState && !SWITicks)
 		{
+			idleLoopWatching = false;
 			if (armState)
 			{
 				if (!armExecute())
-					return;
+					break;
 			}
 			else
 			{
 				if (!thumbExecute())
-					return;
+					break;
 			}
 			clockTicks = 0;
 		}
@@ -1800,9 +2015,9 @@ void CPULoop(int ticks)
 					IRQTicks = 0;
 			}
 
-			lcdTicks -= clockTicks;
+			cpuEventTime += clockTicks;
 
-			if (lcdTicks <= 0)
+			if (lcdTicks <= cpuEventTime)
 			{
 				if (DISPSTAT & 1) // V-BLANK
 				{
@@ -1882,8 +2097,7 @@ void CPULoop(int ticks)
 			// we shouldn't be doing sound in stop state, but we loose synchronization
 			// if sound is disabled, so in stop state, soundTick will just produce
 			// mute sound
-			soundTicks -= clockTicks;
-			if (soundTicks <= 0)
+			if (soundTicks <= cpuEventTime)
 			{
 				psoundTickfn();
 				soundTicks += SOUND_CLOCK_TICKS;
@@ -1893,8 +2107,7 @@ void CPULoop(int ticks)
 			{
 				if (timer0On)
 				{
-					timer0Ticks -= clockTicks;
-					if (timer0Ticks <= 0)
+					if (timer0Ticks <= cpuEventTime)
 					{
 						timer0Ticks += (0x10000 - timer0Reload) << timer0ClockReload;
 						timerOverflow |= 1;
@@ -1905,7 +2118,7 @@ void CPULoop(int ticks)
 							UPDATE_REG(0x202, IF);
 						}
 					}
-					TM0D = 0xFFFF - (timer0Ticks >> timer0ClockReload);
+					TM0D = 0xFFFF - ((timer0Ticks - cpuEventTime) >> timer0ClockReload);
 					UPDATE_REG(0x100, TM0D);
 				}
 
@@ -1913,6 +2126,8 @@ void CPULoop(int ticks)
 				{
 					if (TM1CNT & 4)
 					{
+						// A counting up timer is not clocked, its time stays the same distance ahead
+						timer1Ticks += clockTicks;
 						if (timerOverflow & 1)
 						{
 							++TM1D;
@@ -1932,8 +2147,7 @@ void CPULoop(int ticks)
 					}
 					else
 					{
-						timer1Ticks -= clockTicks;
-						if (timer1Ticks <= 0)
+						if (timer1Ticks <= cpuEventTime)
 						{
 							timer1Ticks += (0x10000 - timer1Reload) << timer1ClockReload;
 							timerOverflow |= 2;
@@ -1944,7 +2158,7 @@ void CPULoop(int ticks)
 								UPDATE_REG(0x202, IF);
 							}
 						}
-						TM1D = 0xFFFF - (timer1Ticks >> timer1ClockReload);
+						TM1D = 0xFFFF - ((timer1Ticks - cpuEventTime) >> timer1ClockReload);
 						UPDATE_REG(0x104, TM1D);
 					}
 				}
@@ -1953,6 +2167,8 @@ void CPULoop(int ticks)
 				{
 					if (TM2CNT & 4)
 					{
+						// A counting up timer is not clocked, its time stays the same distance ahead
+						timer2Ticks += clockTicks;
 						if (timerOverflow & 2)
 						{
 							++TM2D;
@@ -1971,8 +2187,7 @@ void CPULoop(int ticks)
 					}
 					else
 					{
-						timer2Ticks -= clockTicks;
-						if (timer2Ticks <= 0)
+						if (timer2Ticks <= cpuEventTime)
 						{
 							timer2Ticks += (0x10000 - timer2Reload) << timer2ClockReload;
 							timerOverflow |= 4;
@@ -1982,7 +2197,7 @@ void CPULoop(int ticks)
 								UPDATE_REG(0x202, IF);
 							}
 						}
-						TM2D = 0xFFFF - (timer2Ticks >> timer2ClockReload);
+						TM2D = 0xFFFF - ((timer2Ticks - cpuEventTime) >> timer2ClockReload);
 						UPDATE_REG(0x108, TM2D);
 					}
 				}
@@ -1991,6 +2206,8 @@ void CPULoop(int ticks)
 				{
 					if (TM3CNT & 4)
 					{
+						// A counting up timer is not clocked, its time stays the same distance ahead
+						timer3Ticks += clockTicks;
 						if (timerOverflow & 4)
 						{
 							++TM3D;
@@ -2008,8 +2225,7 @@ void CPULoop(int ticks)
 					}
 					else
 					{
-						timer3Ticks -= clockTicks;
-						if (timer3Ticks <= 0)
+						if (timer3Ticks <= cpuEventTime)
 						{
 							timer3Ticks += (0x10000 - timer3Reload) << timer3ClockReload;
 							if (TM3CNT & 0x40)
@@ -2018,11 +2234,23 @@ void CPULoop(int ticks)
 								UPDATE_REG(0x202, IF);
 							}
 						}
-						TM3D = 0xFFFF - (timer3Ticks >> timer3ClockReload);
+						TM3D = 0xFFFF - ((timer3Ticks - cpuEventTime) >> timer3ClockReload);
 						UPDATE_REG(0x10C, TM3D);
 					}
 				}
 			}
+			else
+			{
+				// The timers stand still in stop state
+				if (timer0On)
+					timer0Ticks += clockTicks;
+				if (timer1On)
+					timer1Ticks += clockTicks;
+				if (timer2On)
+					timer2Ticks += clockTicks;
+				if (timer3On)
+					timer3Ticks += clockTicks;
+			}
 
 			timerOverflow = 0;
 
@@ -2105,4 +2333,17 @@ void CPULoop(int ticks)
 				break;
 		}
 	}
+
+	// The times of timers that are off are set again when they are turned on
+	lcdTicks -= cpuEventTime;
+	soundTicks -= cpuEventTime;
+	if (timer0On)
+		timer0Ticks -= cpuEventTime;
+	if (timer1On)
+		timer1Ticks -= cpuEventTime;
+	if (timer2On)
+		timer2Ticks -= cpuEventTime;
+	if (timer3On)
+		timer3Ticks -= cpuEventTime;
+	cpuEventTime = 0;
 }
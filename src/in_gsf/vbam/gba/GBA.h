@@ -43,6 +43,14 @@ union reg_pair
 
 extern memoryMap map[256];
 
+// The first 256 MB of the address space in 32 KB pages, each pointing at the memory it is backed by if reads or writes of it go straight
+// to memory, or nullptr if they have to go through the full handling
+#define CPU_PAGE_SHIFT 15
+#define CPU_PAGE_MASK 0x7FFF
+#define CPU_PAGE_COUNT 0x2000
+extern uint8_t *cpuReadPages[CPU_PAGE_COUNT];
+extern uint8_t *cpuWritePages[CPU_PAGE_COUNT];
+
 extern reg_pair reg[45];
 extern uint8_t biosProtected[4];
 
@@ -53,6 +61,7 @@ extern bool V_FLAG;
 extern bool armIrqEnable;
 extern bool armState;
 extern int armMode;
+extern int cpuEventTime;
 
 int CPULoadRom();
 void CPUUpdateRegister(uint32_t, uint16_t);
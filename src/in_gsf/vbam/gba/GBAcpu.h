@@ -54,6 +54,7 @@ void CPUUpdateCPSR();
 void CPUUpdateFlags(bool breakLoop = true);
 void CPUUndefinedException();
 void CPUSoftwareInterrupt(int comment);
+void CPUCheckIdleLoop();
 
 // Waitstates when accessing data
 inline int dataTicksAccess16(uint32_t address) // DATA 8/16bits NON SEQ
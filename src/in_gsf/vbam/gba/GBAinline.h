@@ -23,12 +23,66 @@ extern bool timer3On;
 extern int timer3Ticks;
 extern int timer3ClockReload;
 extern int cpuTotalTicks;
+extern int cpuEventTime;
+extern uint32_t romOpenBusStart;
+extern bool cpuIdleLoopBroken;
 
-inline uint8_t CPUReadByteQuick(uint32_t addr) { return map[addr >> 24].address[addr & map[addr >> 24].mask]; }
+// Only the loaded image is backed by rom, past it the cartridge bus returns the low 16 bits of the halfword address.  The one exception
+// is the SWI 0xFA / BX LR pair that CPUInit patches in at 0x1FE209C when the image ends before 0x1FE2000.
+inline uint16_t CPUReadRomHalfWord(uint32_t offset)
+{
+	if (offset < romOpenBusStart || ((offset & ~3) == 0x1FE209C && romOpenBusStart < 0x1FE2000))
+		return READ16LE(&rom[offset]);
+	return (offset >> 1) & 0xFFFF;
+}
+
+inline uint32_t CPUReadRomWord(uint32_t offset)
+{
+	if (offset + 4 <= romOpenBusStart)
+		return READ32LE(&rom[offset]);
+	return CPUReadRomHalfWord(offset) | (CPUReadRomHalfWord(offset + 2) << 16);
+}
+
+inline uint8_t CPUReadRomByte(uint32_t offset)
+{
+	if (offset < romOpenBusStart)
+		return rom[offset];
+	return (CPUReadRomHalfWord(offset & ~1) >> ((offset & 1) << 3)) & 0xFF;
+}
+
+// Work RAM, internal RAM and the part of rom covered by the image are mapped in cpuReadPages and cpuWritePages, only the rest goes
+// through the switches below
+inline uint8_t *CPUReadPage(uint32_t address) { return address < (CPU_PAGE_COUNT << CPU_PAGE_SHIFT) ? cpuReadPages[address >> CPU_PAGE_SHIFT] : nullptr; }
 
-inline uint16_t CPUReadHalfWordQuick(uint32_t addr) { return READ16LE(&map[addr >> 24].address[addr & map[addr >> 24].mask]); }
+inline uint8_t *CPUWritePage(uint32_t address) { return address < (CPU_PAGE_COUNT << CPU_PAGE_SHIFT) ? cpuWritePages[address >> CPU_PAGE_SHIFT] : nullptr; }
 
-inline uint32_t CPUReadMemoryQuick(uint32_t addr) { return READ32LE(&map[addr >> 24].address[addr & map[addr >> 24].mask]); }
+// Opcode fetches go through map[], those from rom past the image get the same open bus values as any other read of it
+inline uint8_t CPUReadByteQuick(uint32_t addr)
+{
+	auto &area = map[addr >> 24];
+	uint32_t offset = addr & area.mask;
+	if (area.address == &rom[0] && offset >= romOpenBusStart)
+		return CPUReadRomByte(offset);
+	return area.address[offset];
+}
+
+inline uint16_t CPUReadHalfWordQuick(uint32_t addr)
+{
+	auto &area = map[addr >> 24];
+	uint32_t offset = addr & area.mask;
+	if (area.address == &rom[0] && offset + 2 > romOpenBusStart)
+		return CPUReadRomHalfWord(offset);
+	return READ16LE(&area.address[offset]);
+}
+
+inline uint32_t CPUReadMemoryQuick(uint32_t addr)
+{
+	auto &area = map[addr >> 24];
+	uint32_t offset = addr & area.mask;
+	if (area.address == &rom[0] && offset + 4 > romOpenBusStart)
+		return CPUReadRomWord(offset);
+	return READ32LE(&area.address[offset]);
+}
 
 inline uint32_t CPUReadMemory(uint32_t address)
 {
@@ -38,6 +92,18 @@ inline uint32_t CPUReadMemory(uint32_t address)
 	if (address & 3)
 		address &= ~0x03;
 
+	auto page = CPUReadPage(address);
+	if (page)
+	{
+		value = READ32LE(&page[address & CPU_PAGE_MASK]);
+		if (oldAddress & 3)
+		{
+			int shift = (oldAddress & 3) << 3;
+			value = (value >> shift) | (value << (32 - shift));
+		}
+		return value;
+	}
+
 	switch (address >> 24)
 	{
 		case 0:
@@ -90,7 +156,7 @@ inline uint32_t CPUReadMemory(uint32_t address)
 		case 10:
 		case 11:
 		case 12:
-			value = READ32LE(&rom[address & 0x1FFFFFC]);
+			value = CPUReadRomWord(address & 0x1FFFFFC);
 			break;
 		case 13:
 		case 14:
@@ -128,6 +194,16 @@ inline uint32_t CPUReadHalfWord(uint32_t address)
 	if (address & 1)
 		address &= ~0x01;
 
+	// The GPIO registers in the first page of rom are left to the switch
+	auto page = CPUReadPage(address);
+	if (page && (address & ~0xF) != 0x80000C0)
+	{
+		value = READ16LE(&page[address & CPU_PAGE_MASK]);
+		if (oldAddress & 1)
+			value = (value >> 8) | (value << 24);
+		return value;
+	}
+
 	switch (address >> 24)
 	{
 		case 0:
@@ -153,14 +229,16 @@ inline uint32_t CPUReadHalfWord(uint32_t address)
 				value = READ16LE(&ioMem[address & 0x3fe]);
 				if ((address & 0x3fe) > 0xFF && (address & 0x3fe) < 0x10E)
 				{
+					// The timer counters are worked out from the current time, so a loop reading one never repeats itself
+					cpuIdleLoopBroken = true;
 					if ((address & 0x3fe) == 0x100 && timer0On)
-						value = 0xFFFF - ((timer0Ticks - cpuTotalTicks) >> timer0ClockReload);
+						value = 0xFFFF - ((timer0Ticks - cpuEventTime - cpuTotalTicks) >> timer0ClockReload);
 					else if ((address & 0x3fe) == 0x104 && timer1On && !(TM1CNT & 4))
-						value = 0xFFFF - ((timer1Ticks - cpuTotalTicks) >> timer1ClockReload);
+						value = 0xFFFF - ((timer1Ticks - cpuEventTime - cpuTotalTicks) >> timer1ClockReload);
 					else if ((address & 0x3fe) == 0x108 && timer2On && !(TM2CNT & 4))
-						value = 0xFFFF - ((timer2Ticks - cpuTotalTicks) >> timer2ClockReload);
+						value = 0xFFFF - ((timer2Ticks - cpuEventTime - cpuTotalTicks) >> timer2ClockReload);
 					else if ((address & 0x3fe) == 0x10C && timer3On && !(TM3CNT & 4))
-						value = 0xFFFF - ((timer3Ticks - cpuTotalTicks) >> timer3ClockReload);
+						value = 0xFFFF - ((timer3Ticks - cpuEventTime - cpuTotalTicks) >> timer3ClockReload);
 				}
 			}
 			else if (address < 0x4000400 && ioReadable[address & 0x3fc])
@@ -193,7 +271,7 @@ inline uint32_t CPUReadHalfWord(uint32_t address)
 			if (address == 0x80000c4 || address == 0x80000c6 || address == 0x80000c8)
 				value = 0;
 			else
-				value = READ16LE(&rom[address & 0x1FFFFFE]);
+				value = CPUReadRomHalfWord(address & 0x1FFFFFE);
 			break;
 		case 13:
 		case 14:
@@ -228,6 +306,10 @@ inline int16_t CPUReadHalfWordSigned(uint32_t address)
 
 inline uint8_t CPUReadByte(uint32_t address)
 {
+	auto page = CPUReadPage(address);
+	if (page)
+		return page[address & CPU_PAGE_MASK];
+
 	switch (address >> 24)
 	{
 		case 0:
@@ -264,7 +346,7 @@ inline uint8_t CPUReadByte(uint32_t address)
 		case 10:
 		case 11:
 		case 12:
-			return rom[address & 0x1FFFFFF];
+			return CPUReadRomByte(address & 0x1FFFFFF);
 		case 13:
 		case 14:
 		case 15:
@@ -283,8 +365,17 @@ inline uint8_t CPUReadByte(uint32_t address)
 
 inline void CPUWriteMemory(uint32_t address, uint32_t value)
 {
+	cpuIdleLoopBroken = true;
+
 	address &= 0xFFFFFFFC;
 
+	auto page = CPUWritePage(address);
+	if (page)
+	{
+		WRITE32LE(&page[address & CPU_PAGE_MASK], value);
+		return;
+	}
+
 	switch (address >> 24)
 	{
 		case 0x02:
@@ -319,8 +410,17 @@ inline void CPUWriteMemory(uint32_t address, uint32_t value)
 
 inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
 {
+	cpuIdleLoopBroken = true;
+
 	address &= 0xFFFFFFFE;
 
+	auto page = CPUWritePage(address);
+	if (page)
+	{
+		WRITE16LE(&page[address & CPU_PAGE_MASK], value);
+		return;
+	}
+
 	switch (address >> 24)
 	{
 		case 2:
@@ -351,6 +451,15 @@ inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
 
 inline void CPUWriteByte(uint32_t address, uint8_t b)
 {
+	cpuIdleLoopBroken = true;
+
+	auto page = CPUWritePage(address);
+	if (page)
+	{
+		page[address & CPU_PAGE_MASK] = b;
+		return;
+	}
+
 	switch (address >> 24)
 	{
 		case 2:
@@ -2,6 +2,8 @@
 
 reg_pair reg[45];
 memoryMap map[256];
+uint8_t *cpuReadPages[CPU_PAGE_COUNT];
+uint8_t *cpuWritePages[CPU_PAGE_COUNT];
 bool ioReadable[0x400];
 bool N_FLAG = false;
 bool C_FLAG = false;
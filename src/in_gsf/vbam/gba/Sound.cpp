@@ -5,21 +5,14 @@
 #include "../common/Port.h"
 #include "../apu/Gb_Apu.h"
 #include "../apu/Multi_Buffer.h"
-#include "../common/SoundDriver.h"
 #include "XSFCommon.h"
 
-extern SoundDriver *systemSoundInit();
-
 static const uint32_t NR52 = 0x84;
 
-static std::unique_ptr<SoundDriver> soundDriver;
-
 static const int SOUND_CLOCK_TICKS_ = 167772; // 1/100 second
 
-static uint16_t soundFinalWave[6400];
 static long soundSampleRate = 44100;
 bool soundInterpolation = true;
-static bool soundPaused = true;
 static float soundFiltering = 1.0f;
 int SOUND_CLOCK_TICKS = SOUND_CLOCK_TICKS_;
 int soundTicks = SOUND_CLOCK_TICKS_;
@@ -72,7 +65,7 @@ static Blip_Synth<blip_high_quality, 1> pcm_synth[3]; // 32 kHz, 16 kHz, 8 kHz
 
 static inline blip_time_t blip_time()
 {
-	return SOUND_CLOCK_TICKS - soundTicks;
+	return SOUND_CLOCK_TICKS - (soundTicks - cpuEventTime);
 }
 
 inline void Gba_Pcm::init()
@@ -345,28 +338,20 @@ static void end_frame(blip_time_t time)
 	stereo_buffer->end_frame(time);
 }
 
-void flush_samples(Multi_Buffer *buffer)
+// The samples are left in stereo_buffer until they are read, which has to happen before the next frames fill it past its length
+long soundSamplesAvailable()
 {
-	// We want to write the data frame by frame to support legacy audio drivers
-	// that don't use the length parameter of the write method.
-	// TODO: Update the Win32 audio drivers (DS, OAL, XA2), and flush all the
-	// samples at once to help reducing the audio delay on all platforms.
-	int32_t soundBufferLen = (soundSampleRate / 60) * 4;
-
-	// soundBufferLen should have a whole number of sample pairs
-	assert(!(soundBufferLen % (2 * sizeof(*soundFinalWave))));
-
-	// number of samples in output buffer
-	int32_t out_buf_size = soundBufferLen / sizeof(*soundFinalWave);
+	return stereo_buffer->samples_avail() / 2;
+}
 
-	while (buffer->samples_avail())
-	{
-		long samples_read = buffer->read_samples(reinterpret_cast<blip_sample_t *>(soundFinalWave), out_buf_size);
-		if (soundPaused)
-			soundResume();
+long soundReadSamples(int16_t *out, long count)
+{
+	return stereo_buffer->read_samples(out, count * 2) / 2;
+}
 
-		soundDriver->write(soundFinalWave, samples_read * sizeof(*soundFinalWave));
-	}
+void soundDiscardSamples()
+{
+	stereo_buffer->clear();
 }
 
 static void apply_filtering()
@@ -392,8 +377,6 @@ void psoundTickfn()
 		// Run sound hardware to present
 		end_frame(SOUND_CLOCK_TICKS);
 
-		flush_samples(stereo_buffer.get());
-
 		if (!fEqual(soundFiltering_, soundFiltering))
 			apply_filtering();
 
@@ -444,6 +427,8 @@ static void remake_stereo_buffer()
 	// Stereo_Buffer
 	stereo_buffer.reset(new Stereo_Buffer); // TODO: handle out of memory
 	stereo_buffer->set_sample_rate(soundSampleRate); // TODO: handle out of memory
+	// A frame's samples are taken out of the buffer once all of them are read, so the output is the same however they are read
+	stereo_buffer->disable_immediate_removal();
 
 	// PCM
 	pcm[0].which = 0;
@@ -466,8 +451,6 @@ static void remake_stereo_buffer()
 
 void soundShutdown()
 {
-	soundDriver.reset();
-
 	// APU
 	gb_apu.reset();
 
@@ -475,20 +458,6 @@ void soundShutdown()
 	stereo_buffer.reset();
 }
 
-void soundPause()
-{
-	soundPaused = true;
-	if (soundDriver)
-		soundDriver->pause();
-}
-
-void soundResume()
-{
-	soundPaused = false;
-	if (soundDriver)
-		soundDriver->resume();
-}
-
 void soundSetEnable(int channels)
 {
 	soundEnableFlag = channels;
@@ -497,30 +466,14 @@ void soundSetEnable(int channels)
 
 void soundReset()
 {
-	soundDriver->reset();
-
 	remake_stereo_buffer();
 	reset_apu();
 
-	soundPaused = true;
 	SOUND_CLOCK_TICKS = soundTicks = SOUND_CLOCK_TICKS_;
 
 	soundEvent(NR52, static_cast<uint8_t>(0x80));
 }
 
-bool soundInit()
-{
-	soundDriver.reset(systemSoundInit());
-	if (!soundDriver)
-		return false;
-
-	if (!soundDriver->init(soundSampleRate))
-		return false;
-
-	soundPaused = true;
-	return true;
-}
-
 void soundSetSampleRate(long sampleRate)
 {
 	if (soundSampleRate != sampleRate)
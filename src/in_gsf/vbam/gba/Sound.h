@@ -6,10 +6,6 @@
 
 //// Setup/options (these affect GBA and GB sound)
 
-// Initializes sound and returns true if successful. Sets sound quality to
-// current value in soundQuality global.
-bool soundInit();
-
 // Manages muting bitmask. The bits control the following channels:
 // 0x001 Pulse 1
 // 0x002 Pulse 2
@@ -19,11 +15,7 @@ bool soundInit();
 // 0x200 PCM 2
 void soundSetEnable(int mask);
 
-// Pauses/resumes system sound output
-void soundPause();
-void soundResume();
-
-// Cleans up sound. Afterwards, soundInit() can be called again.
+// Cleans up sound. Afterwards, soundReset() sets it up again.
 void soundShutdown();
 
 //// GBA sound options
@@ -58,8 +50,13 @@ void soundTimerOverflow(int which);
 // Notifies emulator that SOUND_CLOCK_TICKS clocks have passed
 void psoundTickfn();
 extern int SOUND_CLOCK_TICKS; // Number of 16.8 MHz clocks between calls to soundTick()
-extern int soundTicks; // Number of 16.8 MHz clocks until soundTick() will be called
+extern int soundTicks; // Time on the CPU's event clock at which soundTick() will next be called
+
+// Number of stereo samples that have been emulated and not read yet, more become available at the end of each sound frame
+long soundSamplesAvailable();
 
-class Multi_Buffer;
+// Reads up to count stereo samples into out, returning how many were read
+long soundReadSamples(int16_t *out, long count);
 
-void flush_samples(Multi_Buffer *buffer);
+// Throws away the samples that have not been read
+void soundDiscardSamples();
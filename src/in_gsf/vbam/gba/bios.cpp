@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include "GBA.h"
@@ -413,18 +414,118 @@ void BIOS_Div()
 	}
 }
 
-void BIOS_HuffUnComp()
+// The decompression functions go a byte at a time, so rather than always going through the full memory handling for each byte, they
+// are written over one of these.  BIOSMemory is the full memory handling.
+struct BIOSMemory
 {
-	uint32_t source = reg[0].I;
-	uint32_t dest = reg[1].I;
+	uint8_t ReadSource(uint32_t address) const { return CPUReadByte(address); }
+	uint32_t ReadSource32(uint32_t address) const { return CPUReadMemory(address); }
+	uint8_t ReadDest(uint32_t address) const { return CPUReadByte(address); }
+	void Write8(uint32_t address, uint8_t b) const { CPUWriteByte(address, b); }
+	void Write16(uint32_t address, uint16_t value) const { CPUWriteHalfWord(address, value); }
+	void Write32(uint32_t address, uint32_t value) const { CPUWriteMemory(address, value); }
+};
 
-	uint32_t header = CPUReadMemory(source);
-	source += 4;
+// BIOSDirectMemory goes straight to the memory behind the destination, which has to be work RAM or internal RAM throughout, and behind
+// the source for as far as it is work RAM, internal RAM or the rom image.  Reads that fall outside of that, such as LZ77 reading back
+// from before the start of the destination's area or a malformed stream running off the end of the source, still go through the full
+// memory handling.
+struct BIOSDirectMemory
+{
+	const uint8_t *source;
+	uint32_t sourceStart, sourceSize, sourceMask;
+	uint8_t *dest;
+	uint32_t destArea, destMask;
 
-	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
-		return;
+	bool Setup(uint32_t newSource, uint32_t newDest, uint32_t len);
+
+	uint8_t ReadSource(uint32_t address) const
+	{
+		if (address - this->sourceStart < this->sourceSize)
+			return this->source[address & this->sourceMask];
+		return CPUReadByte(address);
+	}
 
-	uint8_t treeSize = CPUReadByte(source++);
+	uint32_t ReadSource32(uint32_t address) const
+	{
+		uint32_t offset = (address & ~3) - this->sourceStart;
+		if (offset >= this->sourceSize || this->sourceSize - offset < 4)
+			return CPUReadMemory(address);
+		uint32_t value = READ32LE(&this->source[(address & ~3) & this->sourceMask]);
+		if (address & 3)
+		{
+			int shift = (address & 3) << 3;
+			value = (value >> shift) | (value << (32 - shift));
+		}
+		return value;
+	}
+
+	uint8_t ReadDest(uint32_t address) const
+	{
+		if ((address >> 24) == this->destArea)
+			return this->dest[address & this->destMask];
+		return CPUReadByte(address);
+	}
+
+	void Write8(uint32_t address, uint8_t b) const { this->dest[address & this->destMask] = b; }
+	void Write16(uint32_t address, uint16_t value) const { WRITE16LE(&this->dest[address & this->destMask & ~1], value); }
+	void Write32(uint32_t address, uint32_t value) const { WRITE32LE(&this->dest[address & this->destMask & ~3], value); }
+};
+
+bool BIOSDirectMemory::Setup(uint32_t newSource, uint32_t newDest, uint32_t len)
+{
+	// Huffman writes a whole word at a time, so up to 3 bytes past the length
+	this->destArea = newDest >> 24;
+	if (((newDest + len + 4) >> 24) != this->destArea)
+		return false;
+	switch (this->destArea)
+	{
+		case 2:
+			this->dest = workRAM;
+			this->destMask = 0x3FFFF;
+			break;
+		case 3:
+			this->dest = internalRAM;
+			this->destMask = 0x7FFF;
+			break;
+		default:
+			return false;
+	}
+
+	this->source = nullptr;
+	this->sourceStart = newSource;
+	this->sourceSize = this->sourceMask = 0;
+	uint32_t areaSize = 0x1000000 - (newSource & 0xFFFFFF);
+	switch (newSource >> 24)
+	{
+		case 2:
+			this->source = workRAM;
+			this->sourceSize = areaSize;
+			this->sourceMask = 0x3FFFF;
+			break;
+		case 3:
+			this->source = internalRAM;
+			this->sourceSize = areaSize;
+			this->sourceMask = 0x7FFF;
+			break;
+		case 8:
+		case 9:
+		case 10:
+		case 11:
+		case 12:
+			if ((newSource & 0x1FFFFFF) < romOpenBusStart)
+			{
+				this->source = rom;
+				this->sourceSize = std::min(areaSize, romOpenBusStart - (newSource & 0x1FFFFFF));
+				this->sourceMask = 0x1FFFFFF;
+			}
+	}
+	return true;
+}
+
+template<typename Memory> static void HuffUnComp(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
+	uint8_t treeSize = memory.ReadSource(source++);
 
 	uint32_t treeStart = source;
 
@@ -433,11 +534,11 @@ void BIOS_HuffUnComp()
 	int len = header >> 8;
 
 	uint32_t mask = 0x80000000;
-	uint32_t data = CPUReadMemory(source);
+	uint32_t data = memory.ReadSource32(source);
 	source += 4;
 
 	int pos = 0;
-	uint8_t rootNode = CPUReadByte(treeStart);
+	uint8_t rootNode = memory.ReadSource(treeStart);
 	uint8_t currentNode = rootNode;
 	bool writeData = false;
 	int byteShift = 0;
@@ -459,14 +560,14 @@ void BIOS_HuffUnComp()
 				// right
 				if (currentNode & 0x40)
 					writeData = true;
-				currentNode = CPUReadByte(treeStart + pos + 1);
+				currentNode = memory.ReadSource(treeStart + pos + 1);
 			}
 			else
 			{
 				// left
 				if (currentNode & 0x80)
 					writeData = true;
-				currentNode = CPUReadByte(treeStart + pos);
+				currentNode = memory.ReadSource(treeStart + pos);
 			}
 
 			if (writeData)
@@ -483,7 +584,7 @@ void BIOS_HuffUnComp()
 				{
 					byteCount = 0;
 					byteShift = 0;
-					CPUWriteMemory(dest, writeValue);
+					memory.Write32(dest, writeValue);
 					writeValue = 0;
 					dest += 4;
 					len -= 4;
@@ -493,7 +594,7 @@ void BIOS_HuffUnComp()
 			if (!mask)
 			{
 				mask = 0x80000000;
-				data = CPUReadMemory(source);
+				data = memory.ReadSource32(source);
 				source += 4;
 			}
 		}
@@ -515,14 +616,14 @@ void BIOS_HuffUnComp()
 				// right
 				if (currentNode & 0x40)
 					writeData = true;
-				currentNode = CPUReadByte(treeStart + pos + 1);
+				currentNode = memory.ReadSource(treeStart + pos + 1);
 			}
 			else
 			{
 				// left
 				if (currentNode & 0x80)
 					writeData = true;
-				currentNode = CPUReadByte(treeStart + pos);
+				currentNode = memory.ReadSource(treeStart + pos);
 			}
 
 			if (writeData)
@@ -546,7 +647,7 @@ void BIOS_HuffUnComp()
 					{
 						byteCount = 0;
 						byteShift = 0;
-						CPUWriteMemory(dest, writeValue);
+						memory.Write32(dest, writeValue);
 						dest += 4;
 						writeValue = 0;
 						len -= 4;
@@ -560,14 +661,14 @@ void BIOS_HuffUnComp()
 			if (!mask)
 			{
 				mask = 0x80000000;
-				data = CPUReadMemory(source);
+				data = memory.ReadSource32(source);
 				source += 4;
 			}
 		}
 	}
 }
 
-void BIOS_LZ77UnCompVram()
+void BIOS_HuffUnComp()
 {
 	uint32_t source = reg[0].I;
 	uint32_t dest = reg[1].I;
@@ -578,6 +679,15 @@ void BIOS_LZ77UnCompVram()
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return;
 
+	BIOSDirectMemory direct;
+	if (direct.Setup(source, dest, header >> 8))
+		HuffUnComp(direct, source, dest, header);
+	else
+		HuffUnComp(BIOSMemory(), source, dest, header);
+}
+
+template<typename Memory> static void LZ77UnCompVram(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int byteCount = 0;
 	int byteShift = 0;
 	uint32_t writeValue = 0;
@@ -586,7 +696,7 @@ void BIOS_LZ77UnCompVram()
 
 	while (len > 0)
 	{
-		uint8_t d = CPUReadByte(source++);
+		uint8_t d = memory.ReadSource(source++);
 
 		if (d)
 		{
@@ -594,20 +704,20 @@ void BIOS_LZ77UnCompVram()
 			{
 				if (d & 0x80)
 				{
-					uint16_t data = CPUReadByte(source++) << 8;
-					data |= CPUReadByte(source++);
+					uint16_t data = memory.ReadSource(source++) << 8;
+					data |= memory.ReadSource(source++);
 					int length = (data >> 12) + 3;
 					int offset = data & 0x0FFF;
 					uint32_t windowOffset = dest + byteCount - offset - 1;
 					for (int i2 = 0; i2 < length; ++i2)
 					{
-						writeValue |= CPUReadByte(windowOffset++) << byteShift;
+						writeValue |= memory.ReadDest(windowOffset++) << byteShift;
 						byteShift += 8;
 						++byteCount;
 
 						if (byteCount == 2)
 						{
-							CPUWriteHalfWord(dest, writeValue);
+							memory.Write16(dest, writeValue);
 							dest += 2;
 							byteCount = 0;
 							byteShift = 0;
@@ -620,13 +730,13 @@ void BIOS_LZ77UnCompVram()
 				}
 				else
 				{
-					writeValue |= CPUReadByte(source++) << byteShift;
+					writeValue |= memory.ReadSource(source++) << byteShift;
 					byteShift += 8;
 					++byteCount;
 
 					if (byteCount == 2)
 					{
-						CPUWriteHalfWord(dest, writeValue);
+						memory.Write16(dest, writeValue);
 						dest += 2;
 						byteCount = 0;
 						byteShift = 0;
@@ -643,12 +753,12 @@ void BIOS_LZ77UnCompVram()
 		{
 			for (int i = 0; i < 8; ++i)
 			{
-				writeValue |= CPUReadByte(source++) << byteShift;
+				writeValue |= memory.ReadSource(source++) << byteShift;
 				byteShift += 8;
 				++byteCount;
 				if (byteCount == 2)
 				{
-					CPUWriteHalfWord(dest, writeValue);
+					memory.Write16(dest, writeValue);
 					dest += 2;
 					byteShift = 0;
 					byteCount = 0;
@@ -662,7 +772,7 @@ void BIOS_LZ77UnCompVram()
 	}
 }
 
-void BIOS_LZ77UnCompWram()
+void BIOS_LZ77UnCompVram()
 {
 	uint32_t source = reg[0].I;
 	uint32_t dest = reg[1].I;
@@ -673,11 +783,20 @@ void BIOS_LZ77UnCompWram()
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return;
 
+	BIOSDirectMemory direct;
+	if (direct.Setup(source, dest, header >> 8))
+		LZ77UnCompVram(direct, source, dest, header);
+	else
+		LZ77UnCompVram(BIOSMemory(), source, dest, header);
+}
+
+template<typename Memory> static void LZ77UnCompWram(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int len = header >> 8;
 
 	while (len > 0)
 	{
-		uint8_t d = CPUReadByte(source++);
+		uint8_t d = memory.ReadSource(source++);
 
 		if (d)
 		{
@@ -685,14 +804,14 @@ void BIOS_LZ77UnCompWram()
 			{
 				if (d & 0x80)
 				{
-					uint16_t data = CPUReadByte(source++) << 8;
-					data |= CPUReadByte(source++);
+					uint16_t data = memory.ReadSource(source++) << 8;
+					data |= memory.ReadSource(source++);
 					int length = (data >> 12) + 3;
 					int offset = data & 0x0FFF;
 					uint32_t windowOffset = dest - offset - 1;
 					for (int i2 = 0; i2 < length; ++i2)
 					{
-						CPUWriteByte(dest++, CPUReadByte(windowOffset++));
+						memory.Write8(dest++, memory.ReadDest(windowOffset++));
 						--len;
 						if (!len)
 							return;
@@ -700,7 +819,7 @@ void BIOS_LZ77UnCompWram()
 				}
 				else
 				{
-					CPUWriteByte(dest++, CPUReadByte(source++));
+					memory.Write8(dest++, memory.ReadSource(source++));
 					--len;
 					if (!len)
 						return;
@@ -712,7 +831,7 @@ void BIOS_LZ77UnCompWram()
 		{
 			for (int i = 0; i < 8; ++i)
 			{
-				CPUWriteByte(dest++, CPUReadByte(source++));
+				memory.Write8(dest++, memory.ReadSource(source++));
 				--len;
 				if (!len)
 					return;
@@ -721,6 +840,24 @@ void BIOS_LZ77UnCompWram()
 	}
 }
 
+void BIOS_LZ77UnCompWram()
+{
+	uint32_t source = reg[0].I;
+	uint32_t dest = reg[1].I;
+
+	uint32_t header = CPUReadMemory(source);
+	source += 4;
+
+	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
+		return;
+
+	BIOSDirectMemory direct;
+	if (direct.Setup(source, dest, header >> 8))
+		LZ77UnCompWram(direct, source, dest, header);
+	else
+		LZ77UnCompWram(BIOSMemory(), source, dest, header);
+}
+
 void BIOS_ObjAffineSet()
 {
 	uint32_t src = reg[0].I;
@@ -836,17 +973,8 @@ void BIOS_RegisterRamReset()
 	BIOS_RegisterRamReset(reg[0].I);
 }
 
-void BIOS_RLUnCompVram()
+template<typename Memory> static void RLUnCompVram(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
 {
-	uint32_t source = reg[0].I;
-	uint32_t dest = reg[1].I;
-
-	uint32_t header = CPUReadMemory(source & 0xFFFFFFFC);
-	source += 4;
-
-	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
-		return;
-
 	int len = header >> 8;
 	int byteCount = 0;
 	int byteShift = 0;
@@ -854,11 +982,11 @@ void BIOS_RLUnCompVram()
 
 	while (len > 0)
 	{
-		uint8_t d = CPUReadByte(source++);
+		uint8_t d = memory.ReadSource(source++);
 		int l = d & 0x7F;
 		if (d & 0x80)
 		{
-			uint8_t data = CPUReadByte(source++);
+			uint8_t data = memory.ReadSource(source++);
 			l += 3;
 			for (int i = 0;i < l; ++i)
 			{
@@ -868,7 +996,7 @@ void BIOS_RLUnCompVram()
 
 				if (byteCount == 2)
 				{
-					CPUWriteHalfWord(dest, writeValue);
+					memory.Write16(dest, writeValue);
 					dest += 2;
 					byteCount = 0;
 					byteShift = 0;
@@ -884,12 +1012,12 @@ void BIOS_RLUnCompVram()
 			++l;
 			for (int i = 0; i < l; ++i)
 			{
-				writeValue |= CPUReadByte(source++) << byteShift;
+				writeValue |= memory.ReadSource(source++) << byteShift;
 				byteShift += 8;
 				++byteCount;
 				if (byteCount == 2)
 				{
-					CPUWriteHalfWord(dest, writeValue);
+					memory.Write16(dest, writeValue);
 					dest += 2;
 					byteCount = 0;
 					byteShift = 0;
@@ -903,7 +1031,7 @@ void BIOS_RLUnCompVram()
 	}
 }
 
-void BIOS_RLUnCompWram()
+void BIOS_RLUnCompVram()
 {
 	uint32_t source = reg[0].I;
 	uint32_t dest = reg[1].I;
@@ -914,19 +1042,28 @@ void BIOS_RLUnCompWram()
 	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
 		return;
 
+	BIOSDirectMemory direct;
+	if (direct.Setup(source, dest, header >> 8))
+		RLUnCompVram(direct, source, dest, header);
+	else
+		RLUnCompVram(BIOSMemory(), source, dest, header);
+}
+
+template<typename Memory> static void RLUnCompWram(const Memory &memory, uint32_t source, uint32_t dest, uint32_t header)
+{
 	int len = header >> 8;
 
 	while (len > 0)
 	{
-		uint8_t d = CPUReadByte(source++);
+		uint8_t d = memory.ReadSource(source++);
 		int l = d & 0x7F;
 		if (d & 0x80)
 		{
-			uint8_t data = CPUReadByte(source++);
+			uint8_t data = memory.ReadSource(source++);
 			l += 3;
 			for (int i = 0; i < l; ++i)
 			{
-				CPUWriteByte(dest++, data);
+				memory.Write8(dest++, data);
 				--len;
 				if (!len)
 					return;
@@ -937,7 +1074,7 @@ void BIOS_RLUnCompWram()
 			++l;
 			for (int i = 0; i < l; ++i)
 			{
-				CPUWriteByte(dest++, CPUReadByte(source++));
+				memory.Write8(dest++, memory.ReadSource(source++));
 				--len;
 				if (!len)
 					return;
@@ -946,6 +1083,24 @@ void BIOS_RLUnCompWram()
 	}
 }
 
+void BIOS_RLUnCompWram()
+{
+	uint32_t source = reg[0].I;
+	uint32_t dest = reg[1].I;
+
+	uint32_t header = CPUReadMemory(source & 0xFFFFFFFC);
+	source += 4;
+
+	if (!(source & 0xe000000) || !((source + ((header >> 8) & 0x1fffff)) & 0xe000000))
+		return;
+
+	BIOSDirectMemory direct;
+	if (direct.Setup(source, dest, header >> 8))
+		RLUnCompWram(direct, source, dest, header);
+	else
+		RLUnCompWram(BIOSMemory(), source, dest, header);
+}
+
 void BIOS_SoftReset()
 {
 	armState = true;
@@ -47,12 +47,13 @@ void XSFPlayer_NCSF::MapNCSFSection(const std::vector<uint8_t> &section)
 	memcpy(&this->sdatData[0], &section[0], size);
 }
 
-bool XSFPlayer_NCSF::MapNCSF(XSFFile *xSFToLoad)
+bool XSFPlayer_NCSF::MapNCSF(const XSFFile *xSFToLoad)
 {
 	if (!xSFToLoad->IsValidType(0x25))
 		return false;
 
-	auto &reservedSection = xSFToLoad->GetReservedSection(), &programSection = xSFToLoad->GetProgramSection();
+	auto reservedSection = xSFToLoad->GetReservedSection();
+	auto &programSection = xSFToLoad->GetProgramSection();
 
 	if (!reservedSection.empty())
 		this->sseq = Get32BitsLE(&reservedSection[0]);
@@ -65,12 +66,12 @@ bool XSFPlayer_NCSF::MapNCSF(XSFFile *xSFToLoad)
 
 bool XSFPlayer_NCSF::RecursiveLoadNCSF(XSFFile *xSFToLoad, int level)
 {
-	if (level <= 10 && xSFToLoad->GetTagExists("_lib"))
+	if (level <= 10 && xSFToLoad->GetTagExists(WellKnownTags::Lib))
 	{
 #ifdef _WIN32
-		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue("_lib")), 8, 12));
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(WellKnownTags::Lib))), 8, 12));
 #else
-		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue("_lib"), 8, 12));
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(WellKnownTags::Lib)), 8, 12));
 #endif
 		if (!this->RecursiveLoadNCSF(libxSF.get(), level + 1))
 			return false;
@@ -89,9 +90,9 @@ bool XSFPlayer_NCSF::RecursiveLoadNCSF(XSFFile *xSFToLoad, int level)
 		{
 			found = true;
 #ifdef _WIN32
-			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue(libTag)), 8, 12));
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(libTag))), 8, 12));
 #else
-			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + xSFToLoad->GetTagValue(libTag), 8, 12));
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSFToLoad->GetFilename()) + std::string(xSFToLoad->GetTagValue(libTag)), 8, 12));
 #endif
 			if (!this->RecursiveLoadNCSF(libxSF.get(), level + 1))
 				return false;
@@ -0,0 +1,128 @@
+/*
+ * xSF - SNSF loader
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Partially based on the vio*sf framework
+ */
+
+#include <algorithm>
+#include <memory>
+#include "convert.h"
+#include "XSFCommon.h"
+#include "SNSFLoader.h"
+
+#undef min
+#undef max
+
+void SNSFImage::MapSection(const std::vector<uint8_t> &section)
+{
+	auto &data = this->rom;
+
+	uint32_t offset = Get32BitsLE(&section[0]), size = Get32BitsLE(&section[4]), finalSize = size + offset;
+	if (!this->first)
+	{
+		this->first = true;
+		this->base = offset;
+	}
+	else
+		offset += this->base;
+	offset &= 0x1FFFFFFF;
+	// Clear keeps the capacity, so the next track from the same set fills the
+	// same storage again instead of growing it section by section.
+	if (data.empty())
+		data.resize(finalSize, 0);
+	else if (data.size() < size + offset)
+		data.resize(size + offset, 0);
+	std::copy_n(&section[8], size, &data[offset]);
+}
+
+bool SNSFImage::Map(const XSFFile *xSF)
+{
+	if (!xSF->IsValidType(0x23))
+		return false;
+
+	auto reservedSection = xSF->GetReservedSection();
+	auto &programSection = xSF->GetProgramSection();
+
+	if (!reservedSection.empty())
+	{
+		size_t reservedPosition = 0, reservedSize = reservedSection.size();
+		while (reservedPosition + 8 < reservedSize)
+		{
+			uint32_t type = Get32BitsLE(&reservedSection[reservedPosition]), size = Get32BitsLE(&reservedSection[reservedPosition + 4]);
+			if (!type)
+			{
+				if (this->sram.empty())
+					this->sram.resize(0x20000, 0xFF);
+				if (reservedPosition + 8 + size > reservedSize)
+					return false;
+				uint32_t offset = Get32BitsLE(&reservedSection[reservedPosition + 8]);
+				if (size > 4 && this->sram.size() > offset)
+				{
+					auto len = std::min<size_t>(size - 4, this->sram.size() - offset);
+					std::copy_n(&reservedSection[reservedPosition + 12], len, &this->sram[offset]);
+				}
+			}
+			reservedPosition += size + 8;
+		}
+	}
+
+	if (!programSection.empty())
+		this->MapSection(programSection);
+
+	return true;
+}
+
+bool SNSFImage::RecursiveLoad(XSFFile *xSF, int level)
+{
+	if (level <= 10 && xSF->GetTagExists(WellKnownTags::Lib))
+	{
+#ifdef _WIN32
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(WellKnownTags::Lib))), 4, 8));
+#else
+		auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(WellKnownTags::Lib)), 4, 8));
+#endif
+		if (!this->RecursiveLoad(libxSF.get(), level + 1))
+			return false;
+	}
+
+	if (!this->Map(xSF))
+		return false;
+
+	unsigned n = 2;
+	bool found;
+	do
+	{
+		found = false;
+		std::string libTag = "_lib" + stringify(n++);
+		if (xSF->GetTagExists(libTag))
+		{
+			found = true;
+#ifdef _WIN32
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ConvertFuncs::StringToWString(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(libTag))), 4, 8));
+#else
+			auto libxSF = std::unique_ptr<XSFFile>(new XSFFile(ExtractDirectoryFromPath(xSF->GetFilename()) + std::string(xSF->GetTagValue(libTag)), 4, 8));
+#endif
+			if (!this->RecursiveLoad(libxSF.get(), level + 1))
+				return false;
+		}
+	} while (found);
+
+	return true;
+}
+
+bool SNSFImage::Load(XSFFile *xSF)
+{
+	this->Clear();
+
+	return this->RecursiveLoad(xSF, 1);
+}
+
+void SNSFImage::Clear()
+{
+	this->rom.clear();
+	this->sram.clear();
+	this->first = false;
+	this->base = 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * xSF - SNSF loader
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Partially based on the vio*sf framework
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "XSFFile.h"
+
+/*
+ * The ROM and SRAM images built up from an SNSF and all of its libraries,
+ * shared between the player and the command-line tools.
+ */
+struct SNSFImage
+{
+	std::vector<uint8_t> rom, sram;
+	bool first;
+	unsigned base;
+
+	SNSFImage() : rom(), sram(), first(false), base(0) { }
+
+	bool Load(XSFFile *xSF);
+	void Clear();
+private:
+	void MapSection(const std::vector<uint8_t> &section);
+	bool Map(const XSFFile *xSF);
+	bool RecursiveLoad(XSFFile *xSF, int level);
+};
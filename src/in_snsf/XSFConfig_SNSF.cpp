@@ -1,7 +1,7 @@
 /*
  * xSF - SNSF configuration
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-24
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  *
@@ -18,7 +18,9 @@ enum
 {
 	idSixteenBitSound = 1000,
 	idReverseStereo,
+	idAudioOnly,
 	idResampler,
+	idResamplerPhases,
 	idMutes
 };
 
@@ -27,7 +29,9 @@ std::string XSFConfig::commonName = "SNSF Decoder";
 std::string XSFConfig::versionNumber = "0.9b";
 //bool XSFConfig_SNSF::initSixteenBitSound = true;
 bool XSFConfig_SNSF::initReverseStereo = false;
+bool XSFConfig_SNSF::initAudioOnly = false;
 unsigned XSFConfig_SNSF::initResampler = 1;
+unsigned XSFConfig_SNSF::initResamplerPhases = 1024;
 std::string XSFConfig_SNSF::initMutes = "00000000";
 
 XSFConfig *XSFConfig::Create()
@@ -35,7 +39,7 @@ XSFConfig *XSFConfig::Create()
 	return new XSFConfig_SNSF();
 }
 
-XSFConfig_SNSF::XSFConfig_SNSF() : XSFConfig(), /*sixteenBitSound(false), */reverseStereo(false), mutes(), resampler(0)
+XSFConfig_SNSF::XSFConfig_SNSF() : XSFConfig(), /*sixteenBitSound(false), */reverseStereo(false), audioOnly(false), mutes(), resampler(0), resamplerPhases(0)
 {
 	this->supportedSampleRates.push_back(8000);
 	this->supportedSampleRates.push_back(11025);
@@ -54,7 +58,9 @@ void XSFConfig_SNSF::LoadSpecificConfig()
 {
 	//this->sixteenBitSound = this->configIO->GetValue("SixteenBitSound", XSFConfig_SNSF::initSixteenBitSound);
 	this->reverseStereo = this->configIO->GetValue("ReverseStereo", XSFConfig_SNSF::initReverseStereo);
+	this->audioOnly = this->configIO->GetValue("AudioOnly", XSFConfig_SNSF::initAudioOnly);
 	this->resampler = this->configIO->GetValue("Resampler", XSFConfig_SNSF::initResampler);
+	this->resamplerPhases = this->configIO->GetValue("ResamplerPhases", XSFConfig_SNSF::initResamplerPhases);
 	std::stringstream mutesSS(this->configIO->GetValue("Mutes", XSFConfig_SNSF::initMutes));
 	mutesSS >> this->mutes;
 }
@@ -63,7 +69,9 @@ void XSFConfig_SNSF::SaveSpecificConfig()
 {
 	//this->configIO->SetValue("SixteenBitSound", this->sixteenBitSound);
 	this->configIO->SetValue("ReverseStereo", this->reverseStereo);
+	this->configIO->SetValue("AudioOnly", this->audioOnly);
 	this->configIO->SetValue("Resampler", this->resampler);
+	this->configIO->SetValue("ResamplerPhases", this->resamplerPhases);
 	this->configIO->SetValue("Mutes", this->mutes.to_string<char>());
 }
 
@@ -73,9 +81,14 @@ void XSFConfig_SNSF::GenerateSpecificDialogs()
 		WithID(idSixteenBitSound));*/
 	this->configDialog.AddCheckBoxControl(DialogCheckBoxBuilder(L"Reverse Stereo").WithSize(80, 10).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 7), 2).WithTabStop().
 		WithID(idReverseStereo));
+	this->configDialog.AddCheckBoxControl(DialogCheckBoxBuilder(L"Audio-Only Emulation").WithSize(90, 10).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 7)).WithTabStop().
+		WithID(idAudioOnly));
 	this->configDialog.AddLabelControl(DialogLabelBuilder(L"Resampler").WithSize(50, 8).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 10)).IsLeftJustified());
 	this->configDialog.AddComboBoxControl(DialogComboBoxBuilder().WithSize(78, 14).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_TOPRIGHT, Point<short>(5, -3)).WithTabStop().IsDropDownList().
 		WithID(idResampler));
+	this->configDialog.AddLabelControl(DialogLabelBuilder(L"Phases").WithSize(50, 8).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 10), 2).IsLeftJustified());
+	this->configDialog.AddComboBoxControl(DialogComboBoxBuilder().WithSize(78, 14).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_TOPRIGHT, Point<short>(5, -3)).WithTabStop().IsDropDownList().
+		WithID(idResamplerPhases));
 	this->configDialog.AddLabelControl(DialogLabelBuilder(L"Mute").WithSize(50, 8).InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_BOTTOMLEFT, Point<short>(0, 10), 2).IsLeftJustified());
 	this->configDialog.AddListBoxControl(DialogListBoxBuilder().WithSize(78, 45).WithExactHeight().InGroup(L"Output").WithRelativePositionToSibling(RelativePosition::FROM_TOPRIGHT, Point<short>(5, -3)).WithID(idMutes).WithBorder().
 		WithVerticalScrollbar().WithMultipleSelect().WithTabStop());
@@ -92,6 +105,9 @@ INT_PTR CALLBACK XSFConfig_SNSF::ConfigDialogProc(HWND hwndDlg, UINT uMsg, WPARA
 			// Reverse Stereo
 			if (this->reverseStereo)
 				SendMessageW(GetDlgItem(hwndDlg, idReverseStereo), BM_SETCHECK, BST_CHECKED, 0);
+			// Audio-Only Emulation
+			if (this->audioOnly)
+				SendMessageW(GetDlgItem(hwndDlg, idAudioOnly), BM_SETCHECK, BST_CHECKED, 0);
 			// Resampler
 			SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"Linear Resampler"));
 			SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"Hermite Resampler"));
@@ -99,6 +115,13 @@ INT_PTR CALLBACK XSFConfig_SNSF::ConfigDialogProc(HWND hwndDlg, UINT uMsg, WPARA
 			SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"Osculating Resampler"));
 			SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"Sinc Resampler"));
 			SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_SETCURSEL, this->resampler, 0);
+			// Resampler Phases
+			for (unsigned phases = 256; phases <= 8192; phases <<= 1)
+			{
+				auto item = SendMessageW(GetDlgItem(hwndDlg, idResamplerPhases), CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(wstringify(phases).c_str()));
+				if (phases == this->resamplerPhases)
+					SendMessageW(GetDlgItem(hwndDlg, idResamplerPhases), CB_SETCURSEL, item, 0);
+			}
 			// Mutes
 			for (int x = 0, numMutes = this->mutes.size(); x < numMutes; ++x)
 			{
@@ -117,7 +140,9 @@ void XSFConfig_SNSF::ResetSpecificConfigDefaults(HWND hwndDlg)
 {
 	//SendMessageW(GetDlgItem(hwndDlg, idSixteenBitSound), BM_SETCHECK, XSFConfig_SNSF::initSixteenBitSound ? BST_CHECKED : BST_UNCHECKED, 0);
 	SendMessageW(GetDlgItem(hwndDlg, idReverseStereo), BM_SETCHECK, XSFConfig_SNSF::initReverseStereo ? BST_CHECKED : BST_UNCHECKED, 0);
+	SendMessageW(GetDlgItem(hwndDlg, idAudioOnly), BM_SETCHECK, XSFConfig_SNSF::initAudioOnly ? BST_CHECKED : BST_UNCHECKED, 0);
 	SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_SETCURSEL, XSFConfig_SNSF::initResampler, 0);
+	SendMessageW(GetDlgItem(hwndDlg, idResamplerPhases), CB_SELECTSTRING, -1, reinterpret_cast<LPARAM>(wstringify(XSFConfig_SNSF::initResamplerPhases).c_str()));
 	auto tmpMutes = std::bitset<8>(XSFConfig_SNSF::initMutes);
 	for (int x = 0, numMutes = tmpMutes.size(); x < numMutes; ++x)
 		SendMessageW(GetDlgItem(hwndDlg, idMutes), LB_SETSEL, tmpMutes[x], x);
@@ -127,7 +152,11 @@ void XSFConfig_SNSF::SaveSpecificConfigDialog(HWND hwndDlg)
 {
 	//this->sixteenBitSound = SendMessageW(GetDlgItem(hwndDlg, idSixteenBitSound), BM_GETCHECK, 0, 0) == BST_CHECKED;
 	this->reverseStereo = SendMessageW(GetDlgItem(hwndDlg, idReverseStereo), BM_GETCHECK, 0, 0) == BST_CHECKED;
+	this->audioOnly = SendMessageW(GetDlgItem(hwndDlg, idAudioOnly), BM_GETCHECK, 0, 0) == BST_CHECKED;
 	this->resampler = static_cast<unsigned>(SendMessageW(GetDlgItem(hwndDlg, idResampler), CB_GETCURSEL, 0, 0));
+	auto phasesIndex = SendMessageW(GetDlgItem(hwndDlg, idResamplerPhases), CB_GETCURSEL, 0, 0);
+	if (phasesIndex != CB_ERR)
+		this->resamplerPhases = 256u << phasesIndex;
 	for (int x = 0, numMutes = this->mutes.size(); x < numMutes; ++x)
 		this->mutes[x] = !!SendMessageW(GetDlgItem(hwndDlg, idMutes), LB_GETSEL, x, 0);
 }
@@ -139,6 +168,8 @@ void XSFConfig_SNSF::CopySpecificConfigToMemory(XSFPlayer *, bool preLoad)
 		memset(&Settings, 0, sizeof(Settings));
 		//Settings.SixteenBitSound = this->sixteenBitSound;
 		Settings.ReverseStereo = this->reverseStereo;
+		Settings.AudioOnly = this->audioOnly;
+		Settings.SoundResamplerPhases = this->resamplerPhases;
 	}
 	else
 		S9xSetSoundControl(static_cast<uint8_t>(this->mutes.to_ulong()) ^ 0xFF);
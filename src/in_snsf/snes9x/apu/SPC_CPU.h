@@ -18,6 +18,13 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 // TODO: remove non-wrapping versions?
 #define SPC_NO_SP_WRAPAROUND 0
 
+// GCC and Clang jump to each opcode through a table of label addresses
+// instead of the switch, so every opcode's handler gets its own entry in the
+// branch predictor.  Each case carries a label for that table.
+#if defined(__GNUC__) && !defined(SPC_CPU_NO_THREADED)
+# define SPC_CPU_THREADED
+#endif
+
 unsigned SNES_SPC::CPU_mem_bit(const uint8_t *pc, rel_time_t rel_time)
 {
 	unsigned addr = get_le16(pc);
@@ -51,6 +58,8 @@ uint8_t *SNES_SPC::run_until_(time_t end_time)
 	this->m.timers[2].next_time += rel_time;
 
 	auto ram = this->m.ram.ram;
+	// Only changed between runs
+	const bool allow_overflow = this->allow_time_overflow;
 	int a = this->m.cpu_regs.a;
 	int x = this->m.cpu_regs.x;
 	int y = this->m.cpu_regs.y;
@@ -156,29 +165,99 @@ uint8_t *SNES_SPC::run_until_(time_t end_time)
 	SET_SP(this->m.cpu_regs.sp);
 	SET_PSW(this->m.cpu_regs.psw);
 
+#ifdef SPC_CPU_THREADED
+# define OPCODE(n) case 0x##n: op_0x##n:
+
+	// Opcodes handled by the address mode macros are labelled by mode and base opcode
+	static const void *const opcode_labels[0x100] =
+	{
+		&&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&dp_0x08, &&abs_only_0x08, &&x_0x08, &&dp_x_ind_0x08,
+		&&imm_0x08, &&dp_dp_0x08, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+		&&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&dp_x_0x08, &&abs_x_0x08, &&abs_y_0x08, &&dp_ind_y_0x08,
+		&&dp_imm_0x08, &&x_y_0x08, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+		&&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&dp_0x28, &&abs_only_0x28, &&x_0x28, &&dp_x_ind_0x28,
+		&&imm_0x28, &&dp_dp_0x28, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+		&&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&dp_x_0x28, &&abs_x_0x28, &&abs_y_0x28, &&dp_ind_y_0x28,
+		&&dp_imm_0x28, &&x_y_0x28, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+		&&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&dp_0x48, &&abs_only_0x48, &&x_0x48, &&dp_x_ind_0x48,
+		&&imm_0x48, &&dp_dp_0x48, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+		&&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&dp_x_0x48, &&abs_x_0x48, &&abs_y_0x48, &&dp_ind_y_0x48,
+		&&dp_imm_0x48, &&x_y_0x48, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+		&&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&dp_0x68, &&abs_only_0x68, &&x_0x68, &&dp_x_ind_0x68,
+		&&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+		&&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&dp_x_0x68, &&abs_x_0x68, &&abs_y_0x68, &&dp_ind_y_0x68,
+		&&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+		&&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&dp_0x88, &&abs_only_0x88, &&x_0x88, &&dp_x_ind_0x88,
+		&&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+		&&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&dp_x_0x88, &&abs_x_0x88, &&abs_y_0x88, &&dp_ind_y_0x88,
+		&&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+		&&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&dp_0x88, &&abs_only_0x88, &&x_0x88, &&dp_x_ind_0x88,
+		&&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+		&&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&dp_x_0x88, &&abs_x_0x88, &&abs_y_0x88, &&dp_ind_y_0x88,
+		&&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+		&&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&abs_only_0xC8, &&x_0xC8, &&dp_x_ind_0xC8,
+		&&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+		&&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&dp_x_0xC8, &&abs_x_0xC8, &&abs_y_0xC8, &&dp_ind_y_0xC8,
+		&&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+		&&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&abs_only_0xE8, &&x_0xE8, &&dp_x_ind_0xE8,
+		&&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+		&&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&dp_x_0xE8, &&abs_x_0xE8, &&abs_y_0xE8, &&dp_ind_y_0xE8,
+		&&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+	};
+#else
+# define OPCODE(n) case 0x##n:
+#endif
+
 	goto loop;
 
 	// Main loop
 
 cbranch_taken_loop:
 	pc += *reinterpret_cast<const int8_t *>(pc);
-inc_pc_loop:
 	++pc;
 loop:
 	unsigned data;
-
-	unsigned opcode = *pc;
-	if (this->allow_time_overflow && rel_time >= 0)
-		goto stop;
-	if ((rel_time += this->m.cycle_table[opcode]) > 0 && !this->allow_time_overflow)
-		goto out_of_time;
+	unsigned opcode;
 
 #ifdef SPC_CPU_OPCODE_HOOK
-	SPC_CPU_OPCODE_HOOK(GET_PC(), opcode);
+# define CALL_OPCODE_HOOK() SPC_CPU_OPCODE_HOOK(GET_PC(), opcode);
+#else
+# define CALL_OPCODE_HOOK()
 #endif
 
 	// TODO: if PC is at end of memory, this will get wrong operand (very obscure)
+#define FETCH_OPCODE() \
+	opcode = *pc; \
+	if (allow_overflow && rel_time >= 0) \
+		goto stop; \
+	if ((rel_time += this->m.cycle_table[opcode]) > 0 && !allow_overflow) \
+		goto out_of_time; \
+	CALL_OPCODE_HOOK() \
 	data = *++pc;
+
+	// Threaded builds fetch and dispatch the next opcode at the end of every
+	// handler, rather than all handlers going back to one copy of it
+#ifdef SPC_CPU_THREADED
+# define NEXT_OPCODE() \
+	do \
+	{ \
+		FETCH_OPCODE() \
+		goto *opcode_labels[opcode]; \
+	} while (0)
+#else
+# define NEXT_OPCODE() goto loop
+#endif
+#define INC_PC_NEXT_OPCODE() \
+	do \
+	{ \
+		++pc; \
+		NEXT_OPCODE(); \
+	} while (0)
+
+	FETCH_OPCODE()
+#ifdef SPC_CPU_THREADED
+	goto *opcode_labels[opcode];
+#endif
 	switch (opcode)
 	{
 		// Common instructions
@@ -188,27 +267,27 @@ loop:
 	++pc; \
 	pc += static_cast<int8_t>(data); \
 	if (cond) \
-		goto loop; \
+		NEXT_OPCODE(); \
 	pc -= static_cast<int8_t>(data); \
 	rel_time -= 2; \
-	goto loop; \
+	NEXT_OPCODE(); \
 }
 
-		case 0xF0: // BEQ
+		OPCODE(F0) // BEQ
 			BRANCH(!static_cast<uint8_t>(nz)) // 89% taken
 
-		case 0xD0: // BNE
+		OPCODE(D0) // BNE
 			BRANCH(static_cast<uint8_t>(nz))
 
-		case 0x3F: // CALL
+		OPCODE(3F) // CALL
 		{
 			int old_addr = GET_PC() + 2;
 			SET_PC(get_le16(pc));
 			PUSH16(old_addr);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x6F:// RET
+		OPCODE(6F)// RET
 #if SPC_NO_SP_WRAPAROUND
 			SET_PC(get_le16(sp));
 			sp += 2;
@@ -218,27 +297,27 @@ loop:
 				SET_PC(get_le16(sp));
 				sp += 2;
 				if (addr < 0x1FF)
-					goto loop;
+					NEXT_OPCODE();
 
 				SET_PC(sp[-0x101] * 0x100 + ram[static_cast<uint8_t>(addr) + 0x100]);
 				sp -= 0x100;
 			}
 #endif
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xE4: // MOV a,dp
+		OPCODE(E4) // MOV a,dp
 			++pc;
 			// 80% from timer
 			a = nz = CPU_READ_TIMER(0, DP_ADDR(data));
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xFA: // MOV dp,dp
+		OPCODE(FA) // MOV dp,dp
 		{
 			int temp = CPU_READ_TIMER(-2, DP_ADDR(data));
 			data = temp + no_read_before_write;
 		}
-		// fall through
-		case 0x8F: // MOV dp,#imm
+		[[fallthrough]];
+		OPCODE(8F) // MOV dp,#imm
 		{
 			int temp = *(pc + 1);
 			pc += 2;
@@ -256,10 +335,10 @@ loop:
 						this->cpu_write_smp_reg(data, rel_time, i);
 				}
 			}
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0xC4: // MOV dp,a
+		OPCODE(C4) // MOV dp,a
 			++pc;
 			{
 				int i = dp + data;
@@ -276,33 +355,37 @@ loop:
 						this->cpu_write_smp_reg_(a, rel_time, i);
 				}
 			}
-			goto loop;
+			NEXT_OPCODE();
 
-#define CASE(n) case n:
+#ifdef SPC_CPU_THREADED
+# define CASE(n, label) case n: label:
+#else
+# define CASE(n, label) case n:
+#endif
 
 // Define common address modes based on opcode for immediate mode. Execution
 // ends with data set to the address of the operand.
 #define ADDR_MODES_(op) \
-	CASE(op - 0x02) /* (X) */ \
+	CASE(op - 0x02, x_##op) /* (X) */ \
 		data = x + dp; \
 		--pc; \
 		goto end_##op; \
-	CASE(op + 0x0F) /* (dp)+Y */ \
+	CASE(op + 0x0F, dp_ind_y_##op) /* (dp)+Y */ \
 		data = READ_PROG16(data + dp) + y; \
 		goto end_##op; \
-	CASE(op - 0x01) /* (dp+X) */ \
+	CASE(op - 0x01, dp_x_ind_##op) /* (dp+X) */ \
 		data = READ_PROG16(static_cast<uint8_t>(data + x) + dp); \
 		goto end_##op; \
-	CASE(op + 0x0E) /* abs+Y */ \
+	CASE(op + 0x0E, abs_y_##op) /* abs+Y */ \
 		data += y; \
 		goto abs_##op; \
-	CASE(op + 0x0D) /* abs+X */ \
+	CASE(op + 0x0D, abs_x_##op) /* abs+X */ \
 		data += x; \
-	CASE(op - 0x03) /* abs */ \
+	CASE(op - 0x03, abs_only_##op) /* abs */ \
 	abs_##op: \
 		data += 0x100 * *(++pc); \
 		goto end_##op; \
-	CASE(op + 0x0C) /* dp+X */ \
+	CASE(op + 0x0C, dp_x_##op) /* dp+X */ \
 		data = static_cast<uint8_t>(data + x);
 
 #define ADDR_MODES_NO_DP(op) \
@@ -312,7 +395,7 @@ loop:
 
 #define ADDR_MODES(op) \
 	ADDR_MODES_(op) \
-	CASE(op - 0x04) /* dp */ \
+	CASE(op - 0x04, dp_##op) /* dp */ \
 		data += dp; \
 	end_##op:
 
@@ -320,139 +403,139 @@ loop:
 
 		ADDR_MODES_NO_DP(0xE8) // MOV A,addr
 			a = nz = this->cpu_read(data, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0xBF: // MOV A,(X)+
+		OPCODE(BF) // MOV A,(X)+
 		{
 			int temp = x + dp;
 			x = static_cast<uint8_t>(x + 1);
 			a = nz = this->cpu_read(temp, rel_time - 1);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0xE8: // MOV A,imm
+		OPCODE(E8) // MOV A,imm
 			a  = data;
 			nz = data;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0xF9: // MOV X,dp+Y
+		OPCODE(F9) // MOV X,dp+Y
 			data = static_cast<uint8_t>(data + y);
-		case 0xF8: // MOV X,dp
+		OPCODE(F8) // MOV X,dp
 			x = nz = CPU_READ_TIMER(0, DP_ADDR(data));
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0xE9: // MOV X,abs
+		OPCODE(E9) // MOV X,abs
 			data = get_le16(pc);
 			++pc;
 			data = this->cpu_read(data, rel_time);
-		case 0xCD: // MOV X,imm
+		OPCODE(CD) // MOV X,imm
 			x  = data;
 			nz = data;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0xFB: // MOV Y,dp+X
+		OPCODE(FB) // MOV Y,dp+X
 			data = static_cast<uint8_t>(data + x);
-		case 0xEB: // MOV Y,dp
+		OPCODE(EB) // MOV Y,dp
 			// 70% from timer
 			++pc;
 			y = nz = CPU_READ_TIMER(0, DP_ADDR(data));
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xEC: // MOV Y,abs
+		OPCODE(EC) // MOV Y,abs
 		{
 			int temp = get_le16(pc);
 			pc += 2;
 			y = nz = CPU_READ_TIMER(0, temp);
 			//y = nz = this->cpu_read(temp, rel_time);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x8D: // MOV Y,imm
+		OPCODE(8D) // MOV Y,imm
 			y  = data;
 			nz = data;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
 		// 2. 8-BIT DATA TRANSMISSION COMMANDS, GROUP 2
 
 		ADDR_MODES_NO_DP(0xC8) // MOV addr,A
 			this->cpu_write(a, data, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
 		{
 			int temp;
-			case 0xCC: // MOV abs,Y
+			OPCODE(CC) // MOV abs,Y
 				temp = y;
 				goto mov_abs_temp;
-			case 0xC9: // MOV abs,X
+			OPCODE(C9) // MOV abs,X
 				temp = x;
 			mov_abs_temp:
 				this->cpu_write(temp, get_le16(pc), rel_time);
 				pc += 2;
-				goto loop;
+				NEXT_OPCODE();
 		}
 
-		case 0xD9: // MOV dp+Y,X
+		OPCODE(D9) // MOV dp+Y,X
 			data = static_cast<uint8_t>(data + y);
-		case 0xD8: // MOV dp,X
+		OPCODE(D8) // MOV dp,X
 			this->cpu_write(x, data + dp, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0xDB: // MOV dp+X,Y
+		OPCODE(DB) // MOV dp+X,Y
 			data = static_cast<uint8_t>(data + x);
-		case 0xCB: // MOV dp,Y
+		OPCODE(CB) // MOV dp,Y
 			this->cpu_write(y, data + dp, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
 		// 3. 8-BIT DATA TRANSMISSIN COMMANDS, GROUP 3.
 
-		case 0x7D: // MOV A,X
+		OPCODE(7D) // MOV A,X
 			a = nz = x;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xDD: // MOV A,Y
+		OPCODE(DD) // MOV A,Y
 			a = nz = y;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x5D: // MOV X,A
+		OPCODE(5D) // MOV X,A
 			x = nz = a;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xFD: // MOV Y,A
+		OPCODE(FD) // MOV Y,A
 			y = nz = a;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x9D: // MOV X,SP
+		OPCODE(9D) // MOV X,SP
 			x = nz = GET_SP();
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xBD: // MOV SP,X
+		OPCODE(BD) // MOV SP,X
 			SET_SP(x);
-			goto loop;
+			NEXT_OPCODE();
 
 		//case 0xC6: // MOV (X),A (handled by MOV addr,A in group 2)
 
-		case 0xAF: // MOV (X)+,A
+		OPCODE(AF) // MOV (X)+,A
 			this->cpu_write(a + no_read_before_write, DP_ADDR(x), rel_time);
 			++x;
-			goto loop;
+			NEXT_OPCODE();
 
 		// 5. 8-BIT LOGIC OPERATION COMMANDS
 
 #define LOGICAL_OP(op, func) \
 	ADDR_MODES(op) /* addr */ \
 		data = this->cpu_read(data, rel_time); \
-	case op: /* imm */ \
+	CASE(op, imm_##op) /* imm */ \
 		nz = a func##= data; \
-		goto inc_pc_loop; \
+		INC_PC_NEXT_OPCODE(); \
 		{ \
 			unsigned addr; \
-			case op + 0x11: /* X,Y */ \
+			CASE(op + 0x11, x_y_##op) /* X,Y */ \
 				data = this->cpu_read(DP_ADDR(y), rel_time - 2); \
 				addr = x + dp; \
 				goto addr_##op; \
-			case op + 0x01: /* dp,dp */ \
+			CASE(op + 0x01, dp_dp_##op) /* dp,dp */ \
 				data = this->cpu_read(DP_ADDR(data), rel_time - 3); \
-			case op + 0x10: /*dp,imm*/ \
+			CASE(op + 0x10, dp_imm_##op) /*dp,imm*/ \
 			{ \
 				auto addr2 = pc + 1; \
 				pc += 2; \
@@ -461,7 +544,7 @@ loop:
 			addr_##op: \
 				nz = data func this->cpu_read(addr, rel_time - 1); \
 				this->cpu_write(nz, addr, rel_time); \
-				goto loop; \
+				NEXT_OPCODE(); \
 		}
 
 		LOGICAL_OP(0x28, &); // AND
@@ -474,68 +557,68 @@ loop:
 
 		ADDR_MODES(0x68) // CMP addr
 			data = this->cpu_read(data, rel_time);
-		case 0x68: // CMP imm
+		OPCODE(68) // CMP imm
 			nz = a - data;
 			c = ~nz;
 			nz &= 0xFF;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0x79: // CMP (X),(Y)
+		OPCODE(79) // CMP (X),(Y)
 			data = this->cpu_read(DP_ADDR(y), rel_time - 2);
 			nz = this->cpu_read(DP_ADDR(x), rel_time - 1) - data;
 			c = ~nz;
 			nz &= 0xFF;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x69: // CMP dp,dp
+		OPCODE(69) // CMP dp,dp
 			data = this->cpu_read(DP_ADDR(data), rel_time - 3);
-		case 0x78: // CMP dp,imm
+		OPCODE(78) // CMP dp,imm
 			nz = this->cpu_read(DP_ADDR(*(++pc)), rel_time - 1) - data;
 			c = ~nz;
 			nz &= 0xFF;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0x3E: // CMP X,dp
+		OPCODE(3E) // CMP X,dp
 			data += dp;
 			goto cmp_x_addr;
-		case 0x1E: // CMP X,abs
+		OPCODE(1E) // CMP X,abs
 			data = get_le16(pc);
 			++pc;
 		cmp_x_addr:
 			data = this->cpu_read(data, rel_time);
-		case 0xC8: // CMP X,imm
+		OPCODE(C8) // CMP X,imm
 			nz = x - data;
 			c = ~nz;
 			nz &= 0xFF;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0x7E: // CMP Y,dp
+		OPCODE(7E) // CMP Y,dp
 			data += dp;
 			goto cmp_y_addr;
-		case 0x5E: // CMP Y,abs
+		OPCODE(5E) // CMP Y,abs
 			data = get_le16(pc);
 			++pc;
 		cmp_y_addr:
 			data = this->cpu_read(data, rel_time);
-		case 0xAD: // CMP Y,imm
+		OPCODE(AD) // CMP Y,imm
 			nz = y - data;
 			c = ~nz;
 			nz &= 0xFF;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
 		{
 			int addr;
-			case 0xB9: // SBC (x),(y)
-			case 0x99: // ADC (x),(y)
+			OPCODE(B9) // SBC (x),(y)
+			OPCODE(99) // ADC (x),(y)
 				--pc; // compensate for inc later
 				data = this->cpu_read(DP_ADDR(y), rel_time - 2);
 				addr = x + dp;
 				goto adc_addr;
-			case 0xA9: // SBC dp,dp
-			case 0x89: // ADC dp,dp
+			OPCODE(A9) // SBC dp,dp
+			OPCODE(89) // ADC dp,dp
 				data = this->cpu_read(DP_ADDR(data), rel_time - 3);
-			case 0xB8: // SBC dp,imm
-			case 0x98: // ADC dp,imm
+			OPCODE(B8) // SBC dp,imm
+			OPCODE(98) // ADC dp,imm
 				addr = *(++pc) + dp;
 			adc_addr:
 				nz = this->cpu_read(addr, rel_time - 1);
@@ -543,11 +626,15 @@ loop:
 
 			// catch ADC and SBC together, then decode later based on operand
 #undef CASE
-#define CASE(n) case n: case (n) + 0x20:
+#ifdef SPC_CPU_THREADED
+# define CASE(n, label) case n: case (n) + 0x20: label:
+#else
+# define CASE(n, label) case n: case (n) + 0x20:
+#endif
 				ADDR_MODES(0x88) // ADC/SBC addr
 				data = this->cpu_read(data, rel_time);
-			case 0xA8: // SBC imm
-			case 0x88: // ADC imm
+			OPCODE(A8) // SBC imm
+			OPCODE(88) // ADC imm
 				addr = -1; // A
 				nz = a;
 			adc_data:
@@ -565,10 +652,10 @@ loop:
 				if (addr < 0)
 				{
 					a = static_cast<uint8_t>(nz);
-					goto inc_pc_loop;
+					INC_PC_NEXT_OPCODE();
 				}
 				this->cpu_write(/*(uint8_t)*/nz, addr, rel_time);
-				goto inc_pc_loop;
+				INC_PC_NEXT_OPCODE();
 			}
 		}
 
@@ -577,92 +664,92 @@ loop:
 #define INC_DEC_REG(reg, op) \
 	nz = reg op; \
 	reg = static_cast<uint8_t>(nz); \
-	goto loop;
+	NEXT_OPCODE();
 
-		case 0xBC: INC_DEC_REG(a, + 1) // INC A
-		case 0x3D: INC_DEC_REG(x, + 1) // INC X
-		case 0xFC: INC_DEC_REG(y, + 1) // INC Y
+		OPCODE(BC) INC_DEC_REG(a, + 1) // INC A
+		OPCODE(3D) INC_DEC_REG(x, + 1) // INC X
+		OPCODE(FC) INC_DEC_REG(y, + 1) // INC Y
 
-		case 0x9C: INC_DEC_REG(a, - 1) // DEC A
-		case 0x1D: INC_DEC_REG(x, - 1) // DEC X
-		case 0xDC: INC_DEC_REG(y, - 1) // DEC Y
+		OPCODE(9C) INC_DEC_REG(a, - 1) // DEC A
+		OPCODE(1D) INC_DEC_REG(x, - 1) // DEC X
+		OPCODE(DC) INC_DEC_REG(y, - 1) // DEC Y
 
-		case 0x9B: // DEC dp+X
-		case 0xBB: // INC dp+X
+		OPCODE(9B) // DEC dp+X
+		OPCODE(BB) // INC dp+X
 			data = static_cast<uint8_t>(data + x);
-		case 0x8B: // DEC dp
-		case 0xAB: // INC dp
+		OPCODE(8B) // DEC dp
+		OPCODE(AB) // INC dp
 			data += dp;
 			goto inc_abs;
-		case 0x8C: // DEC abs
-		case 0xAC: // INC abs
+		OPCODE(8C) // DEC abs
+		OPCODE(AC) // INC abs
 			data = get_le16(pc);
 			++pc;
 		inc_abs:
 			nz = ((opcode >> 4) & 2) - 1;
 			nz += this->cpu_read(data, rel_time - 1);
 			this->cpu_write(/*(uint8_t)*/ nz, data, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
 		// 7. SHIFT, ROTATION COMMANDS
 
-		case 0x5C: // LSR A
+		OPCODE(5C) // LSR A
 			c = 0;
-		case 0x7C: // ROR A
+		OPCODE(7C) // ROR A
 		{
 			nz = ((c >> 1) & 0x80) | (a >> 1);
 			c = a << 8;
 			a = nz;
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x1C: // ASL A
+		OPCODE(1C) // ASL A
 			c = 0;
-		case 0x3C: // ROL A
+		OPCODE(3C) // ROL A
 		{
 			int temp = c >> 8 & 1;
 			c = a << 1;
 			nz = c | temp;
 			a = static_cast<uint8_t>(nz);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x0B: // ASL dp
+		OPCODE(0B) // ASL dp
 			c = 0;
 			data += dp;
 			goto rol_mem;
-		case 0x1B: // ASL dp+X
+		OPCODE(1B) // ASL dp+X
 			c = 0;
-		case 0x3B: // ROL dp+X
+		OPCODE(3B) // ROL dp+X
 			data = static_cast<uint8_t>(data + x);
-		case 0x2B: // ROL dp
+		OPCODE(2B) // ROL dp
 			data += dp;
 			goto rol_mem;
-		case 0x0C: // ASL abs
+		OPCODE(0C) // ASL abs
 			c = 0;
-		case 0x2C: // ROL abs
+		OPCODE(2C) // ROL abs
 			data = get_le16(pc);
 			++pc;
 		rol_mem:
 			nz = c >> 8 & 1;
 			nz |= (c = this->cpu_read(data, rel_time - 1) << 1);
 			this->cpu_write(/*(uint8_t)*/ nz, data, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0x4B: // LSR dp
+		OPCODE(4B) // LSR dp
 			c = 0;
 			data += dp;
 			goto ror_mem;
-		case 0x5B: // LSR dp+X
+		OPCODE(5B) // LSR dp+X
 			c = 0;
-		case 0x7B: // ROR dp+X
+		OPCODE(7B) // ROR dp+X
 			data = static_cast<uint8_t>(data + x);
-		case 0x6B: // ROR dp
+		OPCODE(6B) // ROR dp
 			data += dp;
 			goto ror_mem;
-		case 0x4C: // LSR abs
+		OPCODE(4C) // LSR abs
 			c = 0;
-		case 0x6C: // ROR abs
+		OPCODE(6C) // ROR abs
 			data = get_le16(pc);
 			++pc;
 		ror_mem:
@@ -671,31 +758,31 @@ loop:
 			nz = (c >> 1 & 0x80) | (temp >> 1);
 			c = temp << 8;
 			this->cpu_write(nz, data, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 		}
 
-		case 0x9F: // XCN
+		OPCODE(9F) // XCN
 			nz = a = (a >> 4) | static_cast<uint8_t>(a << 4);
-			goto loop;
+			NEXT_OPCODE();
 
 		// 8. 16-BIT TRANSMISION COMMANDS
 
-		case 0xBA: // MOVW YA,dp
+		OPCODE(BA) // MOVW YA,dp
 			a = this->cpu_read(DP_ADDR(data), rel_time - 2);
 			nz = (a & 0x7F) | (a >> 1);
 			y = this->cpu_read(DP_ADDR(static_cast<uint8_t>(data + 1)), rel_time);
 			nz |= y;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0xDA: // MOVW dp,YA
+		OPCODE(DA) // MOVW dp,YA
 			this->cpu_write(a, DP_ADDR(data), rel_time - 1);
 			this->cpu_write(y + no_read_before_write, DP_ADDR(static_cast<uint8_t>(data + 1)), rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
 		// 9. 16-BIT OPERATION COMMANDS
 
-		case 0x3A: // INCW dp
-		case 0x1A: // DECW dp
+		OPCODE(3A) // INCW dp
+		OPCODE(1A) // DECW dp
 		{
 			int temp;
 			// low byte
@@ -711,11 +798,11 @@ loop:
 			nz |= temp;
 			this->cpu_write(temp, data, rel_time);
 
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 		}
 
-		case 0x7A: // ADDW YA,dp
-		case 0x9A: // SUBW YA,dp
+		OPCODE(7A) // ADDW YA,dp
+		OPCODE(9A) // SUBW YA,dp
 		{
 			int lo = this->cpu_read(DP_ADDR(data), rel_time - 2);
 			int hi = this->cpu_read(DP_ADDR(static_cast<uint8_t>(data + 1)), rel_time);
@@ -737,10 +824,10 @@ loop:
 			y = result;
 			nz = (((lo >> 1) | lo) & 0x7F) | result;
 
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 		}
 
-		case 0x5A: // CMPW YA,dp
+		OPCODE(5A) // CMPW YA,dp
 		{
 			int temp = a - this->cpu_read(DP_ADDR(data), rel_time - 1);
 			nz = ((temp >> 1) | temp) & 0x7F;
@@ -749,22 +836,22 @@ loop:
 			nz |= temp;
 			c  = ~temp;
 			nz &= 0xFF;
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 		}
 
 		// 10. MULTIPLICATION & DIVISON COMMANDS
 
-		case 0xCF: // MUL YA
+		OPCODE(CF) // MUL YA
 		{
 			unsigned temp = y * a;
 			a = static_cast<uint8_t>(temp);
 			nz = ((temp >> 1) | temp) & 0x7F;
 			y = temp >> 8;
 			nz |= y;
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x9E: // DIV YA,X
+		OPCODE(9E) // DIV YA,X
 		{
 			unsigned ya = y * 0x100 + a;
 
@@ -790,12 +877,12 @@ loop:
 			nz = static_cast<uint8_t>(a);
 			a = static_cast<uint8_t>(a);
 
-			goto loop;
+			NEXT_OPCODE();
 		}
 
 		// 11. DECIMAL COMPENSATION COMMANDS
 
-		case 0xDF: // DAA
+		OPCODE(DF) // DAA
 			if (a > 0x99 || c & 0x100)
 			{
 				a += 0x60;
@@ -807,9 +894,9 @@ loop:
 
 			nz = a;
 			a = static_cast<uint8_t>(a);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xBE: // DAS
+		OPCODE(BE) // DAS
 			if (a > 0x99 || !(c & 0x100))
 			{
 				a -= 0x60;
@@ -821,30 +908,30 @@ loop:
 
 			nz = a;
 			a = static_cast<uint8_t>(a);
-			goto loop;
+			NEXT_OPCODE();
 
 		// 12. BRANCHING COMMANDS
 
-		case 0x2F: // BRA rel
+		OPCODE(2F) // BRA rel
 			pc += static_cast<int8_t>(data);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 
-		case 0x30: // BMI
+		OPCODE(30) // BMI
 			BRANCH(nz & nz_neg_mask)
 
-		case 0x10: // BPL
+		OPCODE(10) // BPL
 			BRANCH(!(nz & nz_neg_mask))
 
-		case 0xB0: // BCS
+		OPCODE(B0) // BCS
 			BRANCH(c & 0x100)
 
-		case 0x90: // BCC
+		OPCODE(90) // BCC
 			BRANCH(!(c & 0x100))
 
-		case 0x70: // BVS
+		OPCODE(70) // BVS
 			BRANCH(psw & v40)
 
-		case 0x50: // BVC
+		OPCODE(50) // BVC
 			BRANCH(!(psw & v40))
 
 #define CBRANCH(cond) \
@@ -853,60 +940,60 @@ loop:
 	if (cond) \
 		goto cbranch_taken_loop; \
 	rel_time -= 2; \
-	goto inc_pc_loop; \
+	INC_PC_NEXT_OPCODE(); \
 }
 
-		case 0x03: // BBS dp.bit,rel
-		case 0x23:
-		case 0x43:
-		case 0x63:
-		case 0x83:
-		case 0xA3:
-		case 0xC3:
-		case 0xE3:
+		OPCODE(03) // BBS dp.bit,rel
+		OPCODE(23)
+		OPCODE(43)
+		OPCODE(63)
+		OPCODE(83)
+		OPCODE(A3)
+		OPCODE(C3)
+		OPCODE(E3)
 			CBRANCH((this->cpu_read(DP_ADDR(data), rel_time - 4) >> (opcode >> 5)) & 1)
 
-		case 0x13: // BBC dp.bit,rel
-		case 0x33:
-		case 0x53:
-		case 0x73:
-		case 0x93:
-		case 0xB3:
-		case 0xD3:
-		case 0xF3:
+		OPCODE(13) // BBC dp.bit,rel
+		OPCODE(33)
+		OPCODE(53)
+		OPCODE(73)
+		OPCODE(93)
+		OPCODE(B3)
+		OPCODE(D3)
+		OPCODE(F3)
 			CBRANCH(!((this->cpu_read(DP_ADDR(data), rel_time - 4) >> (opcode >> 5)) & 1))
 
-		case 0xDE: // CBNE dp+X,rel
+		OPCODE(DE) // CBNE dp+X,rel
 			data = static_cast<uint8_t>(data + x);
-			// fall through
-		case 0x2E: // CBNE dp,rel
+			[[fallthrough]];
+		OPCODE(2E) // CBNE dp,rel
 		{
 			// 61% from timer
 			int temp = CPU_READ_TIMER(-4, DP_ADDR(data));
 			CBRANCH(temp != a)
 		}
 
-		case 0x6E: // DBNZ dp,rel
+		OPCODE(6E) // DBNZ dp,rel
 		{
 			unsigned temp = this->cpu_read(DP_ADDR(data), rel_time - 4) - 1;
 			this->cpu_write(/*(uint8_t)*/ temp + no_read_before_write, DP_ADDR(static_cast<uint8_t>(data)), rel_time - 3);
 			CBRANCH(temp)
 		}
 
-		case 0xFE: // DBNZ Y,rel
+		OPCODE(FE) // DBNZ Y,rel
 			y = static_cast<uint8_t>(y - 1);
 			BRANCH(y)
 
-		case 0x1F: // JMP [abs+X]
+		OPCODE(1F) // JMP [abs+X]
 			SET_PC(get_le16(pc) + x);
-			// fall through
-		case 0x5F: // JMP abs
+			[[fallthrough]];
+		OPCODE(5F) // JMP abs
 			SET_PC(get_le16(pc));
-			goto loop;
+			NEXT_OPCODE();
 
 		// 13. SUB-ROUTINE CALL RETURN COMMANDS
 
-		case 0x0F: // BRK
+		OPCODE(0F) // BRK
 		{
 			int temp;
 			int ret_addr = GET_PC();
@@ -915,106 +1002,106 @@ loop:
 			GET_PSW(temp);
 			psw = (psw | b10) & ~i04;
 			PUSH(temp);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x4F: // PCALL offset
+		OPCODE(4F) // PCALL offset
 		{
 			int ret_addr = GET_PC() + 1;
 			SET_PC(0xFF00 | data);
 			PUSH16(ret_addr);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x01: // TCALL n
-		case 0x11:
-		case 0x21:
-		case 0x31:
-		case 0x41:
-		case 0x51:
-		case 0x61:
-		case 0x71:
-		case 0x81:
-		case 0x91:
-		case 0xA1:
-		case 0xB1:
-		case 0xC1:
-		case 0xD1:
-		case 0xE1:
-		case 0xF1:
+		OPCODE(01) // TCALL n
+		OPCODE(11)
+		OPCODE(21)
+		OPCODE(31)
+		OPCODE(41)
+		OPCODE(51)
+		OPCODE(61)
+		OPCODE(71)
+		OPCODE(81)
+		OPCODE(91)
+		OPCODE(A1)
+		OPCODE(B1)
+		OPCODE(C1)
+		OPCODE(D1)
+		OPCODE(E1)
+		OPCODE(F1)
 		{
 			int ret_addr = GET_PC();
 			SET_PC(READ_PROG16(0xFFDE - (opcode >> 3)));
 			PUSH16(ret_addr);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
 		// 14. STACK OPERATION COMMANDS
 
 		{
 			int temp;
-		case 0x7F: // RET1
+		OPCODE(7F) // RET1
 			temp = *sp;
 			SET_PC(get_le16(sp + 1));
 			sp += 3;
 			goto set_psw;
-		case 0x8E: // POP PSW
+		OPCODE(8E) // POP PSW
 			POP(temp);
 		set_psw:
 			SET_PSW(temp);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x0D: // PUSH PSW
+		OPCODE(0D) // PUSH PSW
 		{
 			int temp;
 			GET_PSW(temp);
 			PUSH(temp);
-			goto loop;
+			NEXT_OPCODE();
 		}
 
-		case 0x2D: // PUSH A
+		OPCODE(2D) // PUSH A
 			PUSH(a);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x4D: // PUSH X
+		OPCODE(4D) // PUSH X
 			PUSH(x);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x6D: // PUSH Y
+		OPCODE(6D) // PUSH Y
 			PUSH(y);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xAE: // POP A
+		OPCODE(AE) // POP A
 			POP(a);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xCE: // POP X
+		OPCODE(CE) // POP X
 			POP(x);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xEE: // POP Y
+		OPCODE(EE) // POP Y
 			POP(y);
-			goto loop;
+			NEXT_OPCODE();
 
 		// 15. BIT OPERATION COMMANDS
 
-		case 0x02: // SET1
-		case 0x22:
-		case 0x42:
-		case 0x62:
-		case 0x82:
-		case 0xA2:
-		case 0xC2:
-		case 0xE2:
-		case 0x12: // CLR1
-		case 0x32:
-		case 0x52:
-		case 0x72:
-		case 0x92:
-		case 0xB2:
-		case 0xD2:
-		case 0xF2:
+		OPCODE(02) // SET1
+		OPCODE(22)
+		OPCODE(42)
+		OPCODE(62)
+		OPCODE(82)
+		OPCODE(A2)
+		OPCODE(C2)
+		OPCODE(E2)
+		OPCODE(12) // CLR1
+		OPCODE(32)
+		OPCODE(52)
+		OPCODE(72)
+		OPCODE(92)
+		OPCODE(B2)
+		OPCODE(D2)
+		OPCODE(F2)
 		{
 			int bit = 1 << (opcode >> 5);
 			int mask = ~bit;
@@ -1022,11 +1109,11 @@ loop:
 				bit = 0;
 			data += dp;
 			this->cpu_write((this->cpu_read(data, rel_time - 1) & mask) | bit, data, rel_time);
-			goto inc_pc_loop;
+			INC_PC_NEXT_OPCODE();
 		}
 
-		case 0x0E: // TSET1 abs
-		case 0x4E: // TCLR1 abs
+		OPCODE(0E) // TSET1 abs
+		OPCODE(4E) // TCLR1 abs
 			data = get_le16(pc);
 			pc += 2;
 			{
@@ -1037,34 +1124,34 @@ loop:
 					temp |= a;
 				this->cpu_write(temp, data, rel_time);
 			}
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x4A: // AND1 C,mem.bit
+		OPCODE(4A) // AND1 C,mem.bit
 			c &= MEM_BIT(0);
 			pc += 2;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x6A: // AND1 C,/mem.bit
+		OPCODE(6A) // AND1 C,/mem.bit
 			c &= ~MEM_BIT(0);
 			pc += 2;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x0A: // OR1 C,mem.bit
+		OPCODE(0A) // OR1 C,mem.bit
 			c |= MEM_BIT(-1);
 			pc += 2;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x2A: // OR1 C,/mem.bit
+		OPCODE(2A) // OR1 C,/mem.bit
 			c |= ~MEM_BIT(-1);
 			pc += 2;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x8A: // EOR1 C,mem.bit
+		OPCODE(8A) // EOR1 C,mem.bit
 			c ^= MEM_BIT(-1);
 			pc += 2;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xEA: // NOT1 mem.bit
+		OPCODE(EA) // NOT1 mem.bit
 			data = get_le16(pc);
 			pc += 2;
 			{
@@ -1072,9 +1159,9 @@ loop:
 				temp ^= 1 << (data >> 13);
 				this->cpu_write(temp, data & 0x1FFF, rel_time);
 			}
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xCA: // MOV1 mem.bit,C
+		OPCODE(CA) // MOV1 mem.bit,C
 			data = get_le16(pc);
 			pc += 2;
 			{
@@ -1083,53 +1170,53 @@ loop:
 				temp = (temp & ~(1 << bit)) | ((c >> 8 & 1) << bit);
 				this->cpu_write(temp + no_read_before_write, data & 0x1FFF, rel_time);
 			}
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xAA: // MOV1 C,mem.bit
+		OPCODE(AA) // MOV1 C,mem.bit
 			c = MEM_BIT(0);
 			pc += 2;
-			goto loop;
+			NEXT_OPCODE();
 
 		// 16. PROGRAM PSW FLAG OPERATION COMMANDS
 
-		case 0x60: // CLRC
+		OPCODE(60) // CLRC
 			c = 0;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x80: // SETC
+		OPCODE(80) // SETC
 			c = ~0;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xED: // NOTC
+		OPCODE(ED) // NOTC
 			c ^= 0x100;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xE0: // CLRV
+		OPCODE(E0) // CLRV
 			psw &= ~(v40 | h08);
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x20: // CLRP
+		OPCODE(20) // CLRP
 			dp = 0;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0x40: // SETP
+		OPCODE(40) // SETP
 			dp = 0x100;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xA0: // EI
+		OPCODE(A0) // EI
 			psw |= i04;
-			goto loop;
+			NEXT_OPCODE();
 
-		case 0xC0: // DI
+		OPCODE(C0) // DI
 			psw &= ~i04;
-			goto loop;
+			NEXT_OPCODE();
 
 		// 17. OTHER COMMANDS
 
-		case 0x00: // NOP
-			goto loop;
+		OPCODE(00) // NOP
+			NEXT_OPCODE();
 
-		case 0xFF: // STOP
+		OPCODE(FF) // STOP
 		{
 			// handle PC wrap-around
 			unsigned addr = GET_PC() - 1;
@@ -1137,11 +1224,11 @@ loop:
 			{
 				addr &= 0xFFFF;
 				SET_PC(addr);
-				goto loop;
+				NEXT_OPCODE();
 			}
 		}
-		// fall through
-		case 0xEF: // SLEEP
+		[[fallthrough]];
+		OPCODE(EF) // SLEEP
 			--pc;
 			rel_time = 0;
 			goto stop;
@@ -211,15 +211,11 @@ static const uint8_t APUROM[] =
 namespace spc
 {
 	static bool sound_in_sync = true;
-	static bool sound_enabled = false;
 
 	static int buffer_size;
 	static int lag_master = 0;
 	static int lag = 0;
 
-	static std::unique_ptr<uint8_t[]> landing_buffer;
-	static std::unique_ptr<uint8_t[]> shrink_buffer;
-
 	static std::unique_ptr<Resampler> resampler;
 
 	static int32_t reference_time;
@@ -233,26 +229,6 @@ namespace spc
 	static uint32_t ratio_denominator = APU_DENOMINATOR_NTSC;
 }
 
-static void EightBitize(uint8_t *buffer, int sample_count)
-{
-	int16_t *buf16 = reinterpret_cast<int16_t *>(buffer);
-
-	for (int i = 0; i < sample_count; ++i)
-		buffer[i] = static_cast<uint8_t>((buf16[i] / 256) + 128);
-}
-
-static void DeStereo(uint8_t *buffer, int sample_count)
-{
-	int16_t *buf = reinterpret_cast<int16_t *>(buffer);
-
-	for (int i = 0; i < sample_count >> 1; ++i)
-	{
-		int32_t s1 = static_cast<int32_t>(buf[2 * i]);
-		int32_t s2 = static_cast<int32_t>(buf[2 * i + 1]);
-		buf[i] = static_cast<int16_t>((s1 + s2) >> 1);
-	}
-}
-
 static void ReverseStereo(uint8_t *src_buffer, int sample_count)
 {
 	int16_t *buffer = reinterpret_cast<int16_t *>(src_buffer);
@@ -261,96 +237,51 @@ static void ReverseStereo(uint8_t *src_buffer, int sample_count)
 		std::swap(buffer[i], buffer[i + 1]);
 }
 
-bool S9xMixSamples(uint8_t *buffer, int sample_count)
+// Points the SPC's output at the resampler's input, output is always 16-bit stereo
+static void S9xSetSPCOutput()
 {
-	static int shrink_buffer_size = -1;
-	uint8_t *dest;
+	spc_core->set_output(spc::resampler->write_position(), spc::resampler->space_empty());
+}
 
-	if (!Settings.SixteenBitSound || !Settings.Stereo)
+bool S9xMixSamples(uint8_t *buffer, int sample_count)
+{
+	if (spc::resampler->avail() >= sample_count + spc::lag)
 	{
-		/* We still need both stereo samples for generating the mono sample */
-		if (!Settings.Stereo)
-			sample_count <<= 1;
-
-		/* We still have to generate 16-bit samples for bit-dropping, too */
-		if (shrink_buffer_size < (sample_count << 1))
-		{
-			spc::shrink_buffer.reset(new uint8_t[sample_count << 1]);
-			shrink_buffer_size = sample_count << 1;
-		}
-
-		dest = spc::shrink_buffer.get();
+		spc::resampler->read(reinterpret_cast<short *>(buffer), sample_count);
+		if (spc::lag == spc::lag_master)
+			spc::lag = 0;
 	}
 	else
-		dest = buffer;
-
-	if (Settings.Mute)
 	{
-		std::fill_n(&dest[0], sample_count << 1, 0);
-		spc::resampler->clear();
+		std::fill_n(&buffer[0], sample_count << 1, 0);
+		if (!spc::lag)
+			spc::lag = spc::lag_master;
 
 		return false;
 	}
-	else
-	{
-		if (spc::resampler->avail() >= sample_count + spc::lag)
-		{
-			spc::resampler->read(reinterpret_cast<short *>(dest), sample_count);
-			if (spc::lag == spc::lag_master)
-				spc::lag = 0;
-		}
-		else
-		{
-			std::fill_n(&buffer[0], (sample_count << (Settings.SixteenBitSound ? 1 : 0)) >> (Settings.Stereo ? 0 : 1), Settings.SixteenBitSound ? 0 : 128);
-			if (!spc::lag)
-				spc::lag = spc::lag_master;
-
-			return false;
-		}
-	}
-
-	if (Settings.ReverseStereo && Settings.Stereo)
-		ReverseStereo(dest, sample_count);
 
-	if (!Settings.Stereo || !Settings.SixteenBitSound)
-	{
-		if (!Settings.Stereo)
-		{
-			DeStereo(dest, sample_count);
-			sample_count >>= 1;
-		}
-
-		if (!Settings.SixteenBitSound)
-			EightBitize(dest, sample_count);
-
-		std::copy_n(&dest[0], sample_count << (Settings.SixteenBitSound ? 1 : 0), &buffer[0]);
-	}
+	if (Settings.ReverseStereo)
+		ReverseStereo(buffer, sample_count);
 
 	return true;
 }
 
 int S9xGetSampleCount()
 {
-	return spc::resampler->avail() >> (Settings.Stereo ? 0 : 1);
+	// The resamplers come out below 0 when all of their input has been taken
+	// partway between two input samples
+	return std::max(spc::resampler->avail(), 0);
 }
 
 void S9xFinalizeSamples()
 {
-	if (!Settings.Mute)
-	{
-		if (!spc::resampler->push(reinterpret_cast<short *>(spc::landing_buffer.get()), spc_core->sample_count()))
-		{
-			/* We weren't able to process the entire buffer. Potential overrun. */
-			spc::sound_in_sync = false;
-
-			if (Settings.SoundSync && !Settings.TurboMode)
-				return;
-		}
-	}
+	// The SPC wrote into the resampler's input, anything past the space it
+	// had was held back by the SPC and comes first in the next output
+	spc::resampler->written(spc_core->sample_count());
 
-	spc::sound_in_sync = !Settings.SoundSync || Settings.TurboMode || Settings.Mute || spc::resampler->space_empty() >= spc::resampler->space_filled();
+	spc::sound_in_sync = !Settings.SoundSync || Settings.TurboMode || spc::resampler->space_empty() >= spc::resampler->space_filled();
 
-	spc_core->set_output(reinterpret_cast<SNES_SPC::sample_t *>(spc::landing_buffer.get()), spc::buffer_size >> 1);
+	S9xSetSPCOutput();
 }
 
 void S9xLandSamples()
@@ -375,6 +306,8 @@ static void UpdatePlaybackRate()
 
 	double time_ratio = static_cast<double>(Settings.SoundInputRate) * spc::timing_hack_numerator / (Settings.SoundPlaybackRate * spc::timing_hack_denominator);
 	spc::resampler->time_ratio(time_ratio);
+	// Changing the ratio drops any waiting input, so the SPC writes to the front again
+	S9xSetSPCOutput();
 }
 
 template<class ResamplerClass> bool S9xInitSound(int buffer_ms, int lag_ms)
@@ -385,40 +318,26 @@ template<class ResamplerClass> bool S9xInitSound(int buffer_ms, int lag_ms)
 	int sample_count = buffer_ms * 32000 / 1000;
 	int lag_sample_count = lag_ms * 32000 / 1000;
 
-	spc::lag_master = lag_sample_count;
-	if (Settings.Stereo)
-		spc::lag_master <<= 1;
+	// Output is always 16-bit stereo
+	spc::lag_master = lag_sample_count << 1;
 	spc::lag = spc::lag_master;
 
 	if (sample_count < APU_MINIMUM_SAMPLE_COUNT)
 		sample_count = APU_MINIMUM_SAMPLE_COUNT;
 
-	spc::buffer_size = sample_count;
-	if (Settings.Stereo)
-		spc::buffer_size <<= 1;
-	if (Settings.SixteenBitSound)
-		spc::buffer_size <<= 1;
-
-	spc::landing_buffer.reset(new uint8_t[spc::buffer_size * 2]);
-	if (!spc::landing_buffer)
-		return false;
+	spc::buffer_size = sample_count << 2;
 
 	/* The resampler and spc unit use samples (16-bit short) as
 	 *   arguments. Use 2x in the resampler for buffer leveling with SoundSync */
 	spc::resampler.reset(new ResamplerClass(spc::buffer_size >> (Settings.SoundSync ? 0 : 1)));
 	if (!spc::resampler)
-	{
-		spc::landing_buffer.reset();
 		return false;
-	}
 
-	spc_core->set_output(reinterpret_cast<SNES_SPC::sample_t *>(spc::landing_buffer.get()), spc::buffer_size >> 1);
+	spc::resampler->set_phases(Settings.SoundResamplerPhases);
 
 	UpdatePlaybackRate();
 
-	spc::sound_enabled = S9xOpenSoundDevice();
-
-	return spc::sound_enabled;
+	return S9xOpenSoundDevice();
 }
 
 template bool S9xInitSound<LinearResampler>(int, int);
@@ -432,13 +351,6 @@ void S9xSetSoundControl(uint8_t voice_switch)
 	spc_core->dsp_set_stereo_switch((voice_switch << 8) | voice_switch);
 }
 
-void S9xSetSoundMute(bool mute)
-{
-	Settings.Mute = mute;
-	if (!spc::sound_enabled)
-		Settings.Mute = true;
-}
-
 bool S9xInitAPU()
 {
 	spc_core.reset(new SNES_SPC);
@@ -448,8 +360,6 @@ bool S9xInitAPU()
 	spc_core->init();
 	spc_core->init_rom(APUROM);
 
-	spc::landing_buffer.reset();
-	spc::shrink_buffer.reset();
 	spc::resampler.reset();
 
 	return true;
@@ -459,8 +369,6 @@ void S9xDeinitAPU()
 {
 	spc_core.reset();
 	spc::resampler.reset();
-	spc::landing_buffer.reset();
-	spc::shrink_buffer.reset();
 }
 
 static inline int S9xAPUGetClock(int32_t cpucycles)
@@ -527,7 +435,6 @@ void S9xResetAPU()
 	spc::reference_time = 0;
 	spc::remainder = 0;
 	spc_core->reset();
-	spc_core->set_output(reinterpret_cast<SNES_SPC::sample_t *>(spc::landing_buffer.get()), spc::buffer_size >> 1);
-
 	spc::resampler->clear();
+	S9xSetSPCOutput();
 }
@@ -196,5 +196,4 @@ bool S9xOpenSoundDevice();
 bool S9xSyncSound();
 int S9xGetSampleCount();
 void S9xSetSoundControl(uint8_t);
-void S9xSetSoundMute(bool);
 bool S9xMixSamples(uint8_t *, int);
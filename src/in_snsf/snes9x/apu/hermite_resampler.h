@@ -52,7 +52,7 @@ public:
 
 	void clear()
 	{
-		ring_buffer::clear();
+		Resampler::clear();
 		this->r_frac = 1.0;
 		this->r_left[0] = this->r_left[1] = this->r_left[2] = this->r_left[3] = 0;
 		this->r_right[0] = this->r_right[1] = this->r_right[2] = this->r_right[3] = 0;
@@ -60,16 +60,14 @@ public:
 
 	void read(short *data, int num_samples)
 	{
-		int i_position = this->start >> 1;
-		short *internal_buffer = reinterpret_cast<short *>(&this->buffer[0]);
+		const short *input = &this->buffer[this->start];
 		int o_position = 0;
 		int consumed = 0;
 
-		while (o_position < num_samples && consumed < this->buffer_size)
+		while (o_position < num_samples && consumed < this->size)
 		{
-			int s_left = internal_buffer[i_position];
-			int s_right = internal_buffer[i_position + 1];
-			int max_samples = this->buffer_size >> 1;
+			int s_left = input[consumed];
+			int s_right = input[consumed + 1];
 			static const double margin_of_error = 1.0e-10;
 
 			if (std::abs(this->r_step - 1.0) < margin_of_error)
@@ -78,9 +76,6 @@ public:
 				data[o_position + 1] = static_cast<short>(s_right);
 
 				o_position += 2;
-				i_position += 2;
-				if (i_position >= max_samples)
-					i_position -= max_samples;
 				consumed += 2;
 
 				continue;
@@ -110,21 +105,16 @@ public:
 
 				this->r_frac -= 1.0;
 
-				i_position += 2;
-				if (i_position >= max_samples)
-					i_position -= max_samples;
 				consumed += 2;
 			}
 		}
 
-		this->size -= consumed << 1;
-		this->start += consumed << 1;
-		if (this->start >= this->buffer_size)
-			this->start -= this->buffer_size;
+		this->size -= consumed;
+		this->start += consumed;
 	}
 
 	int avail()
 	{
-		return static_cast<int>(std::floor(((this->size >> 2) - this->r_frac) / this->r_step) * 2);
+		return static_cast<int>(std::floor(((this->size >> 1) - this->r_frac) / this->r_step) * 2);
 	}
 };
@@ -35,7 +35,7 @@ public:
 
 	void clear()
 	{
-		ring_buffer::clear();
+		Resampler::clear();
 		this->f__r_frac = 0;
 		this->r_left = 0;
 		this->r_right = 0;
@@ -43,23 +43,18 @@ public:
 
 	void read(short *data, int num_samples)
 	{
-		int i_position = this->start >> 1;
-		short *internal_buffer = reinterpret_cast<short *>(&this->buffer[0]);
+		const short *input = &this->buffer[this->start];
 		int o_position = 0;
 		int consumed = 0;
-		int max_samples = this->buffer_size >> 1;
 
-		while (o_position < num_samples && consumed < this->buffer_size)
+		while (o_position < num_samples && consumed < this->size)
 		{
 			if (this->f__r_step == f__one)
 			{
-				data[o_position] = internal_buffer[i_position];
-				data[o_position + 1] = internal_buffer[i_position + 1];
+				data[o_position] = input[consumed];
+				data[o_position + 1] = input[consumed + 1];
 
 				o_position += 2;
-				i_position += 2;
-				if (i_position >= max_samples)
-					i_position -= max_samples;
 				consumed += 2;
 
 				continue;
@@ -67,8 +62,8 @@ public:
 
 			while (this->f__r_frac <= f__one && o_position < num_samples)
 			{
-				data[o_position] = lerp(this->f__r_frac, this->r_left, internal_buffer[i_position]);
-				data[o_position + 1] = lerp(this->f__r_frac, this->r_right, internal_buffer[i_position + 1]);
+				data[o_position] = lerp(this->f__r_frac, this->r_left, input[consumed]);
+				data[o_position + 1] = lerp(this->f__r_frac, this->r_right, input[consumed + 1]);
 
 				o_position += 2;
 
@@ -78,23 +73,18 @@ public:
 			if (this->f__r_frac > f__one)
 			{
 				this->f__r_frac -= f__one;
-				this->r_left = internal_buffer[i_position];
-				this->r_right = internal_buffer[i_position + 1];
-				i_position += 2;
-				if (i_position >= max_samples)
-					i_position -= max_samples;
+				this->r_left = input[consumed];
+				this->r_right = input[consumed + 1];
 				consumed += 2;
 			}
 		}
 
-		this->size -= consumed << 1;
-		this->start += consumed << 1;
-		if (this->start >= this->buffer_size)
-			this->start -= this->buffer_size;
+		this->size -= consumed;
+		this->start += consumed;
 	}
 
 	int avail()
 	{
-		return (((this->size >> 2) * this->f__inv_r_step) - ((this->f__r_frac * this->f__inv_r_step) >> f_prec)) >> (f_prec - 1);
+		return (((this->size >> 1) * this->f__inv_r_step) - ((this->f__r_frac * this->f__inv_r_step) >> f_prec)) >> (f_prec - 1);
 	}
 };
@@ -0,0 +1,165 @@
+/* Polyphase filter bank base for the resamplers based on bsnes's ruby audio library */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include "resampler.h"
+
+// The convolution uses SSE2 where the compiler can always use it, and a plain loop otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define POLYPHASE_RESAMPLER_SSE2
+# include <emmintrin.h>
+#endif
+
+// Every output sample falls some fraction of the way between two input
+// samples.  The weights for each of TAPS input samples are worked out once, in
+// double precision, for phases + 1 evenly spaced fractions and kept as floats.
+// Each output sample then picks the nearest fraction's weights and convolves
+// left and right together, as the history keeps them interleaved.
+template<unsigned TAPS> class PolyphaseResampler : public Resampler
+{
+protected:
+	static const unsigned DEFAULT_PHASES = 1024;
+
+	double r_step;
+	double r_frac;
+	unsigned phases;
+	// phases + 1 rows of TAPS weights, each weight repeated for left and right
+	std::vector<float> bank;
+	// The last TAPS input frames, stored twice over so that the newest TAPS of them are always contiguous
+	float history[TAPS * 4];
+	unsigned history_pos;
+
+	template<typename T1, typename T2> static T1 CLAMP(T1 x, T2 low, T2 high) { return x > high ? high : (x < low ? low : x); }
+	template<typename T> static short SHORT_CLAMP(T n) { return static_cast<short>(CLAMP(n, -32768, 32767)); }
+
+	// The weights of the TAPS input samples, oldest first, for an output
+	// sample mu of the way from input TAPS / 2 - 1 to input TAPS / 2
+	virtual void weights(double mu, double *w) = 0;
+
+	void build_bank()
+	{
+		double w[TAPS];
+		this->bank.resize((this->phases + 1) * TAPS * 2);
+		for (unsigned p = 0; p <= this->phases; ++p)
+		{
+			this->weights(static_cast<double>(p) / this->phases, w);
+			for (unsigned t = 0; t < TAPS; ++t)
+				this->bank[(p * TAPS + t) * 2] = this->bank[(p * TAPS + t) * 2 + 1] = static_cast<float>(w[t]);
+		}
+	}
+
+	void push_history(int left, int right)
+	{
+		unsigned pos = this->history_pos;
+		this->history[pos * 2] = this->history[(pos + TAPS) * 2] = static_cast<float>(left);
+		this->history[pos * 2 + 1] = this->history[(pos + TAPS) * 2 + 1] = static_cast<float>(right);
+		this->history_pos = pos + 1 == TAPS ? 0 : pos + 1;
+	}
+
+	void convolve(short *out)
+	{
+		const float *kernel = &this->bank[static_cast<unsigned>(this->r_frac * this->phases + 0.5) * TAPS * 2];
+		const float *window = &this->history[this->history_pos * 2];
+#ifdef POLYPHASE_RESAMPLER_SSE2
+		__m128 sum = _mm_mul_ps(_mm_loadu_ps(kernel), _mm_loadu_ps(window));
+		for (unsigned i = 4; i < TAPS * 2; i += 4)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + i), _mm_loadu_ps(window + i)));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		// Truncates like SHORT_CLAMP, which saturating to 16 bits then matches too
+		__m128i samples = _mm_cvttps_epi32(sum);
+		samples = _mm_packs_epi32(samples, samples);
+		int32_t pair = _mm_cvtsi128_si32(samples);
+		std::copy_n(reinterpret_cast<const short *>(&pair), 2, out);
+#else
+		float left = 0.0f, right = 0.0f;
+		for (unsigned i = 0; i < TAPS * 2; i += 2)
+		{
+			left += kernel[i] * window[i];
+			right += kernel[i + 1] * window[i + 1];
+		}
+		out[0] = SHORT_CLAMP(left);
+		out[1] = SHORT_CLAMP(right);
+#endif
+	}
+
+public:
+	PolyphaseResampler(int num_samples) : Resampler(num_samples), r_step(1.0), phases(DEFAULT_PHASES), bank()
+	{
+		this->clear();
+	}
+
+	void set_phases(unsigned new_phases)
+	{
+		this->phases = new_phases ? new_phases : DEFAULT_PHASES;
+		if (!this->bank.empty())
+			this->build_bank();
+	}
+
+	void time_ratio(double ratio)
+	{
+		this->r_step = ratio;
+		this->build_bank();
+		this->clear();
+	}
+
+	void clear()
+	{
+		Resampler::clear();
+		this->r_frac = 1.0;
+		std::fill_n(&this->history[0], TAPS * 4, 0.0f);
+		this->history_pos = 0;
+	}
+
+	void read(short *data, int num_samples)
+	{
+		const short *input = &this->buffer[this->start];
+		int o_position = 0;
+		int consumed = 0;
+
+		while (o_position < num_samples && consumed < this->size)
+		{
+			static const double margin_of_error = 1.0e-10;
+
+			if (std::abs(this->r_step - 1.0) < margin_of_error)
+			{
+				data[o_position] = input[consumed];
+				data[o_position + 1] = input[consumed + 1];
+
+				o_position += 2;
+				consumed += 2;
+
+				continue;
+			}
+
+			while (this->r_frac <= 1.0 && o_position < num_samples)
+			{
+				this->convolve(&data[o_position]);
+
+				o_position += 2;
+
+				this->r_frac += this->r_step;
+			}
+
+			if (this->r_frac > 1.0)
+			{
+				this->push_history(input[consumed], input[consumed + 1]);
+
+				this->r_frac -= 1.0;
+
+				consumed += 2;
+			}
+		}
+
+		this->size -= consumed;
+		this->start += consumed;
+	}
+
+	int avail()
+	{
+		return static_cast<int>(std::floor(((this->size >> 1) - this->r_frac) / this->r_step) * 2);
+	}
+};
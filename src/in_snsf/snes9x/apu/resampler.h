@@ -2,17 +2,28 @@
 
 #pragma once
 
-#include "ring_buffer.h"
+#include <memory>
+#include <algorithm>
 
-class Resampler : public ring_buffer
+// The SPC writes its interleaved 16-bit stereo samples straight into the
+// resampler's input buffer, and read() resamples them straight into the
+// player's buffer.  Samples waiting to be read are kept at the front.
+class Resampler
 {
+protected:
+	std::unique_ptr<short[]> buffer;
+	int buffer_size;
+	int start;
+	int size;
+
 public:
-	virtual void clear() = 0;
 	virtual void time_ratio(double) = 0;
 	virtual void read(short *, int) = 0;
 	virtual int avail() = 0;
+	// Only the polyphase resamplers have a phase count, 0 picks their default
+	virtual void set_phases(unsigned) { }
 
-	Resampler(int num_samples) : ring_buffer(num_samples << 1)
+	Resampler(int num_samples) : buffer(new short[num_samples]), buffer_size(num_samples), start(0), size(0)
 	{
 	}
 
@@ -20,23 +31,37 @@ public:
 	{
 	}
 
-	bool push(short *src, int num_samples)
+	virtual void clear()
 	{
-		if (this->max_write() < num_samples)
-			return false;
+		this->start = this->size = 0;
+	}
 
-		!num_samples || ring_buffer::push(reinterpret_cast<unsigned char *>(src), num_samples << 1);
+	// Where the next input samples are to be written, after moving any still
+	// waiting to the front.  space_empty() samples fit there.
+	short *write_position()
+	{
+		if (this->start)
+		{
+			std::copy_n(&this->buffer[this->start], this->size, &this->buffer[0]);
+			this->start = 0;
+		}
+		return &this->buffer[this->size];
+	}
 
-		return true;
+	// Takes num_samples written at write_position() as input, the SPC counts
+	// the samples it had to hold back for lack of space too
+	void written(int num_samples)
+	{
+		this->size += std::min(num_samples, this->buffer_size - this->start - this->size);
 	}
 
-	int max_write()
+	int space_empty()
 	{
-		return this->space_empty () >> 1;
+		return this->buffer_size - this->size;
 	}
 
-	void resize(int num_samples)
+	int space_filled()
 	{
-		ring_buffer::resize(num_samples << 1);
+		return this->size;
 	}
 };
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <algorithm>
+#include <vector>
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "resampler.h"
@@ -19,11 +20,17 @@ protected:
 	static const unsigned SINC_RESOLUTION = 8192;
 	static const unsigned SINC_WIDTH = 8;
 	static const unsigned SINC_SAMPLES = SINC_RESOLUTION * SINC_WIDTH;
+	// Each kernel is SINC_WIDTH * 2 weights followed by their sum
+	static const unsigned KERNEL_SIZE = SINC_WIDTH * 2 + 1;
 	static double sinc_lut[SINC_SAMPLES + 1];
 
 	double r_step;
 	double r_frac;
-	int r_left[SINC_WIDTH * 2], r_right[SINC_WIDTH * 2];
+	// The kernel for every one of the SINC_RESOLUTION + 1 positions between two input samples, for the current ratio
+	std::vector<double> kernels;
+	// The last SINC_WIDTH * 2 input samples, stored twice over so that they are always contiguous from r_pos
+	double r_left[SINC_WIDTH * 4], r_right[SINC_WIDTH * 4];
+	unsigned r_pos;
 
 	template<typename T1, typename T2> static T1 CLAMP(T1 x, T2 low, T2 high) { return x > high ? high : (x < low ? low : x); }
 	template<typename T> static short SHORT_CLAMP(T n) { return static_cast<short>(CLAMP(n, -32768, 32767)); }
@@ -33,25 +40,38 @@ protected:
 		return fEqual(x, 0.0) ? 1.0 : std::sin(x * M_PI) / (x * M_PI);
 	}
 
-	double sinc(const int *data)
+	// The output only ever lands on one of SINC_RESOLUTION + 1 positions, so the kernels are built from the LUT once per ratio instead
+	// of for every output sample, with the weights and their sum added up in the same order as when they were built per sample
+	void build_kernels()
 	{
-		double kernel[SINC_WIDTH * 2], kernel_sum = 0.0;
-		int i = SINC_WIDTH, shift = static_cast<int>(std::floor(this->r_frac * SINC_RESOLUTION));
+		this->kernels.resize((SINC_RESOLUTION + 1) * KERNEL_SIZE);
 		int step = this->r_step > 1.0 ? static_cast<int>(SINC_RESOLUTION / this->r_step) : SINC_RESOLUTION;
-		int shift_adj = shift * step / SINC_RESOLUTION;
-		for (; i >= -static_cast<int>(SINC_WIDTH - 1); --i)
+		for (unsigned shift = 0; shift <= SINC_RESOLUTION; ++shift)
 		{
-			int pos = i * step;
-			kernel_sum += kernel[i + SINC_WIDTH - 1] = this->sinc_lut[std::abs(shift_adj - pos)];
+			double *kernel = &this->kernels[shift * KERNEL_SIZE], kernel_sum = 0.0;
+			int shift_adj = static_cast<int>(shift) * step / SINC_RESOLUTION;
+			for (int i = SINC_WIDTH; i >= -static_cast<int>(SINC_WIDTH - 1); --i)
+				kernel_sum += kernel[i + SINC_WIDTH - 1] = this->sinc_lut[std::abs(shift_adj - i * step)];
+			kernel[SINC_WIDTH * 2] = kernel_sum;
 		}
-		double sum = 0.0;
-		for (i = 0; i < static_cast<int>(SINC_WIDTH * 2); ++i)
-			sum += data[i] * kernel[i];
-		return sum / kernel_sum;
+	}
+
+	void sinc(short *out)
+	{
+		const double *kernel = &this->kernels[static_cast<int>(std::floor(this->r_frac * SINC_RESOLUTION)) * KERNEL_SIZE];
+		const double *left = &this->r_left[this->r_pos], *right = &this->r_right[this->r_pos];
+		double left_sum = 0.0, right_sum = 0.0;
+		for (unsigned i = 0; i < SINC_WIDTH * 2; ++i)
+		{
+			left_sum += left[i] * kernel[i];
+			right_sum += right[i] * kernel[i];
+		}
+		out[0] = SHORT_CLAMP(left_sum / kernel[SINC_WIDTH * 2]);
+		out[1] = SHORT_CLAMP(right_sum / kernel[SINC_WIDTH * 2]);
 	}
 
 public:
-	SincResampler(int num_samples) : Resampler(num_samples)
+	SincResampler(int num_samples) : Resampler(num_samples), r_step(1.0), kernels()
 	{
 		if (!this->initializedLUTs)
 		{
@@ -66,40 +86,35 @@ public:
 	void time_ratio(double ratio)
 	{
 		this->r_step = ratio;
+		this->build_kernels();
 		this->clear();
 	}
 
 	void clear()
 	{
-		ring_buffer::clear();
+		Resampler::clear();
 		this->r_frac = 1.0;
-		std::fill_n(&this->r_left[0], SINC_WIDTH * 2, 0);
-		std::fill_n(&this->r_right[0], SINC_WIDTH * 2, 0);
+		std::fill_n(&this->r_left[0], SINC_WIDTH * 4, 0.0);
+		std::fill_n(&this->r_right[0], SINC_WIDTH * 4, 0.0);
+		this->r_pos = 0;
 	}
 
 	void read(short *data, int num_samples)
 	{
-		int i_position = this->start >> 1;
-		short *internal_buffer = reinterpret_cast<short *>(&this->buffer[0]);
+		const short *input = &this->buffer[this->start];
 		int o_position = 0;
 		int consumed = 0;
 
-		while (o_position < num_samples && consumed < this->buffer_size)
+		while (o_position < num_samples && consumed < this->size)
 		{
-			int s_left = internal_buffer[i_position];
-			int s_right = internal_buffer[i_position + 1];
-			int max_samples = this->buffer_size >> 1;
 			static const double margin_of_error = 1.0e-10;
 
 			if (std::abs(this->r_step - 1.0) < margin_of_error)
 			{
-				data[o_position] = static_cast<short>(s_left);
-				data[o_position + 1] = static_cast<short>(s_right);
+				data[o_position] = input[consumed];
+				data[o_position + 1] = input[consumed + 1];
 
 				o_position += 2;
-				i_position += 2;
-				if (i_position >= max_samples)
-					i_position -= max_samples;
 				consumed += 2;
 
 				continue;
@@ -107,8 +122,7 @@ public:
 
 			while (this->r_frac <= 1.0 && o_position < num_samples)
 			{
-				data[o_position] = SHORT_CLAMP(sinc(this->r_left));
-				data[o_position + 1] = SHORT_CLAMP(sinc(this->r_right));
+				this->sinc(&data[o_position]);
 
 				o_position += 2;
 
@@ -117,29 +131,23 @@ public:
 
 			if (this->r_frac > 1.0)
 			{
-				std::copy_n(&this->r_left[1], SINC_WIDTH * 2 - 1, &this->r_left[0]);
-				this->r_left[SINC_WIDTH * 2 - 1] = s_left;
-
-				std::copy_n(&this->r_right[1], SINC_WIDTH * 2 - 1, &this->r_right[0]);
-				this->r_right[SINC_WIDTH * 2 - 1] = s_right;
+				unsigned pos = this->r_pos;
+				this->r_left[pos] = this->r_left[pos + SINC_WIDTH * 2] = input[consumed];
+				this->r_right[pos] = this->r_right[pos + SINC_WIDTH * 2] = input[consumed + 1];
+				this->r_pos = pos + 1 == SINC_WIDTH * 2 ? 0 : pos + 1;
 
 				this->r_frac -= 1.0;
 
-				i_position += 2;
-				if (i_position >= max_samples)
-					i_position -= max_samples;
 				consumed += 2;
 			}
 		}
 
-		this->size -= consumed << 1;
-		this->start += consumed << 1;
-		if (this->start >= this->buffer_size)
-			this->start -= this->buffer_size;
+		this->size -= consumed;
+		this->start += consumed;
 	}
 
 	int avail()
 	{
-		return static_cast<int>(std::floor(((this->size >> 2) - this->r_frac) / this->r_step) * 2);
+		return static_cast<int>(std::floor(((this->size >> 1) - this->r_frac) / this->r_step) * 2);
 	}
 };
@@ -199,6 +199,7 @@ static void S9xSoftResetCPU()
 	CPU.WhichEvent = HC_RENDER_EVENT;
 	CPU.NextEvent  = Timings.RenderPos;
 	CPU.WaitingForInterrupt = false;
+	S9xResetIdleLoop();
 
 	Registers.PC.xPBPC = 0;
 	Registers.PC.B.xPB = 0;
@@ -240,7 +241,8 @@ static void S9xResetCPU()
 void S9xReset()
 {
 	std::fill_n(&Memory.RAM[0], 0x20000, 0x55);
-	std::fill_n(&Memory.VRAM[0], 0x10000, 0);
+	if (Memory.VRAM)
+		std::fill_n(&Memory.VRAM[0], 0x10000, 0);
 	std::fill_n(&Memory.FillRAM[0], 0x8000, 0);
 
 	S9xResetCPU();
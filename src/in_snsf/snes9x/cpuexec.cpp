@@ -181,6 +181,9 @@
 #include "dma.h"
 #include "apu/apu.h"
 
+// The H-blank start and render events do nothing but move on to the next
+// one, so the audio-only profile leaves them out of the schedule.  Fewer
+// events also leave longer stretches for idle loops to be skipped over.
 static inline void S9xReschedule()
 {
 	switch (CPU.WhichEvent)
@@ -201,6 +204,13 @@ static inline void S9xReschedule()
 			break;
 
 		case HC_HDMA_INIT_EVENT:
+			if (Settings.AudioOnly)
+			{
+				CPU.WhichEvent = HC_WRAM_REFRESH_EVENT;
+				CPU.NextEvent = Timings.WRAMRefreshPos;
+				break;
+			}
+
 			CPU.WhichEvent = HC_RENDER_EVENT;
 			CPU.NextEvent = Timings.RenderPos;
 			break;
@@ -211,11 +221,190 @@ static inline void S9xReschedule()
 			break;
 
 		case HC_WRAM_REFRESH_EVENT:
+			if (Settings.AudioOnly)
+			{
+				CPU.WhichEvent = HC_HDMA_START_EVENT;
+				CPU.NextEvent = Timings.HDMAStart;
+				break;
+			}
+
 			CPU.WhichEvent = HC_HBLANK_START_EVENT;
 			CPU.NextEvent = Timings.HBlankStart;
 	}
 }
 
+// Moves CPU.Cycles forward by whole passes of an idle loop, each taking length
+// cycles, stopping short of the first point where a pass could behave
+// differently: the next H event, a pending NMI, the H-IRQ position or the
+// start or end of H-blank (which $4212 reports). The start of H-blank is an
+// event of its own only outside the audio-only profile, so it is checked here
+// too. The APU clock is derived from CPU.Cycles, so it stays in step without
+// anything else to do.
+static void S9xSkipIdleCycles(int32_t length)
+{
+	if (CPU.IRQTransition || (CPU.IRQLine && (PPU.HTimerEnabled || PPU.VTimerEnabled)))
+		return;
+
+	int32_t limit = CPU.NextEvent;
+	if (CPU.NMILine && Timings.NMITriggerPos < limit)
+		limit = Timings.NMITriggerPos;
+	if (PPU.HTimerEnabled && PPU.HTimerPosition > CPU.Cycles && PPU.HTimerPosition < limit)
+		limit = PPU.HTimerPosition;
+	if (Timings.HBlankEnd > CPU.Cycles && Timings.HBlankEnd < limit)
+		limit = Timings.HBlankEnd;
+	if (Timings.HBlankStart > CPU.Cycles && Timings.HBlankStart < limit)
+		limit = Timings.HBlankStart;
+
+	if (CPU.Cycles + length >= limit)
+		return;
+
+	int32_t skipped = (limit - 1 - CPU.Cycles) / length * length;
+	CPU.Cycles += skipped;
+	CPU.PrevCycles += skipped;
+}
+
+// Reads that give the same value every time until the next event or
+// interrupt: plain memory, RDNMI (which clears its flag on the first read) and
+// HVBJOY.
+static bool S9xIdleLoopReadIsPure(uint32_t address, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		uint32_t a = (address + i) & 0xffffff;
+		uint8_t *GetAddress = Memory.Map[a >> MEMMAP_SHIFT];
+
+		if (GetAddress >= reinterpret_cast<uint8_t *>(CMemory::MAP_LAST))
+			continue;
+
+		if (GetAddress != reinterpret_cast<uint8_t *>(CMemory::MAP_CPU) || ((a & 0xffff) != 0x4210 && (a & 0xffff) != 0x4212))
+			return false;
+	}
+
+	return true;
+}
+
+// A loop body qualifies when it is straight-line loads, compares and logic
+// ops on pure reads, ending in the branch back to its head. Nothing in it can
+// then change anything but the registers, so a pass that leaves the registers
+// as it found them will keep doing so.
+static bool S9xIdleLoopIsPure(uint16_t head, uint16_t end)
+{
+	if (!CPU.PCBase || (head & ~MEMMAP_MASK) != ((end - 1) & ~MEMMAP_MASK))
+		return false;
+
+	int widthM = CheckMemory() ? 1 : 2;
+	int widthX = CheckIndex() ? 1 : 2;
+
+	for (uint16_t pc = head; pc != end; )
+	{
+		const uint8_t *op = &CPU.PCBase[pc];
+		uint16_t length = ICPU.S9xOpLengths[op[0]];
+		if (pc + length > end)
+			return false;
+
+		switch (op[0])
+		{
+			// Branches, only as the final instruction
+			case 0x10: case 0x30: case 0x50: case 0x70:
+			case 0x80: case 0x90: case 0xb0: case 0xd0: case 0xf0:
+				if (pc + length != end)
+					return false;
+				break;
+
+			// Immediate LDA, LDX, LDY, CMP, CPX, CPY, BIT, AND, ORA, EOR, and NOP
+			case 0xa9: case 0xa2: case 0xa0: case 0xc9: case 0xe0:
+			case 0xc0: case 0x89: case 0x29: case 0x09: case 0x49:
+			case 0xea:
+				break;
+
+			// Direct page
+			case 0xa5: case 0xc5: case 0x24: case 0x25: case 0x05: case 0x45:
+				if (!S9xIdleLoopReadIsPure(static_cast<uint16_t>(Registers.D.W + op[1]), widthM))
+					return false;
+				break;
+
+			case 0xa6: case 0xa4: case 0xe4: case 0xc4:
+				if (!S9xIdleLoopReadIsPure(static_cast<uint16_t>(Registers.D.W + op[1]), widthX))
+					return false;
+				break;
+
+			// Absolute
+			case 0xad: case 0xcd: case 0x2c: case 0x2d: case 0x0d: case 0x4d:
+				if (!S9xIdleLoopReadIsPure(ICPU.ShiftedDB + (op[1] | (op[2] << 8)), widthM))
+					return false;
+				break;
+
+			case 0xae: case 0xac: case 0xec: case 0xcc:
+				if (!S9xIdleLoopReadIsPure(ICPU.ShiftedDB + (op[1] | (op[2] << 8)), widthX))
+					return false;
+				break;
+
+			// Absolute long
+			case 0xaf: case 0xcf: case 0x2f: case 0x0f: case 0x4f:
+				if (!S9xIdleLoopReadIsPure(op[1] | (op[2] << 8) | (op[3] << 16), widthM))
+					return false;
+				break;
+
+			default:
+				return false;
+		}
+
+		pc += length;
+	}
+
+	return true;
+}
+
+static inline void S9xSaveIdleLoopState()
+{
+	IdleLoop.Cycles = CPU.Cycles;
+	IdleLoop.V_Counter = CPU.V_Counter;
+	IdleLoop.WhichEvent = CPU.WhichEvent;
+	IdleLoop.Registers = Registers;
+	IdleLoop._Carry = ICPU._Carry;
+	IdleLoop._Zero = ICPU._Zero;
+	IdleLoop._Negative = ICPU._Negative;
+	IdleLoop._Overflow = ICPU._Overflow;
+}
+
+static inline bool S9xIdleLoopStateUnchanged()
+{
+	// An H event or interrupt in between would show up as a change here, since
+	// every event moves on to the next one and interrupts reset the loop
+	return CPU.V_Counter == IdleLoop.V_Counter && CPU.WhichEvent == IdleLoop.WhichEvent &&
+		Registers.PC.xPBPC == IdleLoop.Registers.PC.xPBPC && Registers.P.W == IdleLoop.Registers.P.W &&
+		Registers.A.W == IdleLoop.Registers.A.W && Registers.X.W == IdleLoop.Registers.X.W &&
+		Registers.Y.W == IdleLoop.Registers.Y.W && Registers.S.W == IdleLoop.Registers.S.W &&
+		Registers.D.W == IdleLoop.Registers.D.W && Registers.DB == IdleLoop.Registers.DB &&
+		ICPU._Carry == IdleLoop._Carry && ICPU._Zero == IdleLoop._Zero &&
+		ICPU._Negative == IdleLoop._Negative && ICPU._Overflow == IdleLoop._Overflow;
+}
+
+// Called after a short loop branches back to its head. Any way out of a pure
+// body other than the branch (falling through it, or an interrupt) resets the
+// tracked loop, so two arrivals in a row mean exactly one pass ran in between.
+// If that pass left everything as it was, every pass until the next event
+// will too, and they are skipped.
+void S9xCheckIdleLoop(uint16_t end)
+{
+	if (Registers.PC.xPBPC != IdleLoop.Head || end != IdleLoop.End)
+	{
+		IdleLoop.Head = Registers.PC.xPBPC;
+		IdleLoop.End = end;
+		IdleLoop.Pure = S9xIdleLoopIsPure(Registers.PC.W.xPC, end);
+		S9xSaveIdleLoopState();
+		return;
+	}
+
+	if (!IdleLoop.Pure)
+		return;
+
+	if (S9xIdleLoopStateUnchanged())
+		S9xSkipIdleCycles(CPU.Cycles - IdleLoop.Cycles);
+
+	S9xSaveIdleLoopState();
+}
+
 void S9xMainLoop()
 {
 	for (;;)
@@ -232,6 +421,7 @@ void S9xMainLoop()
 					++Registers.PC.W.xPC;
 				}
 
+				S9xResetIdleLoop();
 				S9xOpcode_NMI();
 			}
 		}
@@ -252,13 +442,20 @@ void S9xMainLoop()
 				CPU.IRQPending = Timings.IRQPendCount;
 
 				if (!CheckFlag(IRQ))
+				{
+					S9xResetIdleLoop();
 					S9xOpcode_IRQ();
+				}
 			}
 		}
 
 		if (CPU.Flags & SCAN_KEYS_FLAG)
 			break;
 
+		// WAI spends one opcode fetch and two cycles per pass until it is woken
+		if (CPU.WaitingForInterrupt && CPU.PCBase)
+			S9xSkipIdleCycles(CPU.MemSpeed + TWO_CYCLES);
+
 		uint8_t Op;
 		SOpcodes *Opcodes;
 
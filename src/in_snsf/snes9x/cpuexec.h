@@ -212,9 +212,37 @@ extern uint8_t S9xOpLengthsM0X0[256];
 void S9xMainLoop();
 void S9xReset();
 void S9xDoHEventProcessing();
+void S9xCheckIdleLoop(uint16_t);
 
 #include "65c816.h"
 
+// Longest loop, in bytes, that is checked for being an idle loop
+const uint16_t IDLE_LOOP_WINDOW = 16;
+
+// The last short loop branched back to, kept to spot a loop that only polls
+// memory and can be skipped ahead to the next event or interrupt
+struct SIdleLoop
+{
+	uint32_t Head;
+	uint16_t End;
+	bool Pure;
+	int32_t Cycles;
+	int32_t V_Counter;
+	uint8_t WhichEvent;
+	SRegisters Registers;
+	uint8_t _Carry;
+	uint8_t _Zero;
+	uint8_t _Negative;
+	uint8_t _Overflow;
+};
+
+extern SIdleLoop IdleLoop;
+
+inline void S9xResetIdleLoop()
+{
+	IdleLoop.Head = 0xffffffff;
+}
+
 inline void S9xUnpackStatus()
 {
 	ICPU._Zero = !(Registers.P.B.l & Zero);
@@ -265,6 +265,7 @@ template<typename F> inline void bOP(F rel, bool cond, bool e)
 	newPC.W = rel(JUMP);
 	if (cond)
 	{
+		uint16_t end = Registers.PC.W.xPC;
 		AddCycles(ONE_CYCLE);
 		if (e && Registers.PC.B.xPCh != newPC.B.h)
 			AddCycles(ONE_CYCLE);
@@ -272,7 +273,11 @@ template<typename F> inline void bOP(F rel, bool cond, bool e)
 			S9xSetPCBase(ICPU.ShiftedPB + newPC.W);
 		else
 			Registers.PC.W.xPC = newPC.W;
+		if (newPC.W < end && end - newPC.W <= IDLE_LOOP_WINDOW)
+			S9xCheckIdleLoop(end);
 	}
+	else if (newPC.W < Registers.PC.W.xPC)
+		S9xResetIdleLoop();
 }
 
 inline void SetZN(uint16_t Work16)
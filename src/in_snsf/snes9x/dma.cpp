@@ -273,15 +273,12 @@ bool S9xDoDMA(uint8_t Channel)
 	{
 		if (d->AAddressFixed && Memory.FillRAM[0x4801] > 0)
 		{
-			// XXX: Should probably verify that we're DMAing from ROM?
-			// And somewhere we should make sure we're not running across a mapping boundary too.
-			// Hacky support for pre-decompressed S-DD1 data
+			// Hacky support for pre-decompressed S-DD1 data: SNSF rips carry
+			// what the sound driver needs already decompressed, so there is
+			// no decompressor and the transfer reads the zeroed buffer, with
+			// the same timing as the real one.
 			inc = !d->AAddressDecrement ? 1 : -1;
 
-			uint8_t *in_ptr = S9xGetBasePointer((d->ABank << 16) | d->AAddress);
-			if (in_ptr)
-				in_ptr += d->AAddress;
-
 			in_sdd1_dma = sdd1_decode_buffer;
 		}
 
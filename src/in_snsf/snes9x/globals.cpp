@@ -182,6 +182,7 @@
 SCPUState CPU;
 SICPU ICPU;
 SRegisters Registers;
+SIdleLoop IdleLoop;
 SPPU PPU;
 InternalPPU IPPU;
 SDMA DMA[8];
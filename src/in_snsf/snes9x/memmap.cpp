@@ -210,23 +210,81 @@ static void S9xDeinterleaveType1(int size, uint8_t *base)
 
 // allocation and deallocation
 
+// Deinit hands the buffers back here and the next Init takes them again, so
+// consecutive tracks, which mostly come from the same set and so need the
+// same ROM size, do not allocate anything.  Only ROM buffers up to 4 MB are
+// kept, so between tracks the pool never holds more than that plus the RAM.
+static struct
+{
+	std::unique_ptr<uint8_t[]> RAM, SRAM, VRAM, RealROM;
+	uint32_t ROMBufferSize;
+} pool;
+static const uint32_t MAX_POOLED_ROM_SIZE = 0x400000;
+
 bool CMemory::Init()
 {
-	this->RAM.reset(new uint8_t[0x20000]);
-	this->SRAM.reset(new uint8_t[0x20000]);
-	this->VRAM.reset(new uint8_t[0x10000]);
-	this->RealROM.reset(new uint8_t[MAX_ROM_SIZE + 0x200 + 0x8000]);
+	this->RAM = pool.RAM ? std::move(pool.RAM) : std::unique_ptr<uint8_t[]>(new uint8_t[0x20000]);
+	this->SRAM = pool.SRAM ? std::move(pool.SRAM) : std::unique_ptr<uint8_t[]>(new uint8_t[0x20000]);
+	// Nothing that reaches the APU can see what is in VRAM, so the audio-only
+	// profile goes without it
+	if (!Settings.AudioOnly)
+		this->VRAM = pool.VRAM ? std::move(pool.VRAM) : std::unique_ptr<uint8_t[]>(new uint8_t[0x10000]);
+	this->RealROM = std::move(pool.RealROM);
+	this->ROMBufferSize = this->RealROM ? pool.ROMBufferSize : 0;
+
+	std::fill_n(&this->RAM[0], 0x20000, 0);
+	std::fill_n(&this->SRAM[0], 0x20000, 0);
+	if (this->VRAM)
+		std::fill_n(&this->VRAM[0], 0x10000, 0);
 
-	if (!this->RAM || !this->SRAM || !this->VRAM || !this->RealROM)
+	// The ROM buffer is sized by LoadROMSNSF, this only makes sure FillRAM
+	// and the smallest ROM the header detection reads from are there.
+	this->ROM = nullptr;
+	this->ReserveROM(0x10000);
+	std::fill_n(&this->RealROM[0], this->ROMBufferSize + 0x200 + 0x8000, 0);
+
+	return true;
+}
+
+void CMemory::Deinit()
+{
+	pool.RAM = std::move(this->RAM);
+	pool.SRAM = std::move(this->SRAM);
+	if (this->VRAM)
+		pool.VRAM = std::move(this->VRAM);
+	// Anything larger, which the Jumbo LoROM, ROM24MBS and S-DD1 maps always
+	// reserve, is freed here
+	if (this->ROMBufferSize <= MAX_POOLED_ROM_SIZE)
 	{
-		this->Deinit();
-		return false;
+		pool.RealROM = std::move(this->RealROM);
+		pool.ROMBufferSize = this->ROMBufferSize;
 	}
+	this->RealROM.reset();
+	this->ROM = this->FillRAM = nullptr;
+	this->ROMBufferSize = 0;
 
-	std::fill_n(&this->RAM[0], 0x20000, 0);
-	std::fill_n(&this->SRAM[0], 0x20000, 0);
-	std::fill_n(&this->VRAM[0], 0x10000, 0);
-	std::fill_n(&this->RealROM[0], MAX_ROM_SIZE + 0x200 + 0x8000, 0);
+	this->Safe(nullptr);
+}
+
+// Makes ROM hold at least size bytes, plus room for a copier header, keeping
+// what is already in it and FillRAM.  Mapping points into the buffer, so this
+// must come before any of the Map_* functions do.
+void CMemory::ReserveROM(uint32_t size)
+{
+	if (this->RealROM && this->ROMBufferSize >= size)
+	{
+		this->FillRAM = &this->RealROM[0];
+		this->ROM = &this->RealROM[0x8000];
+		return;
+	}
+
+	auto buffer = std::unique_ptr<uint8_t[]>(new uint8_t[size + 0x200 + 0x8000]);
+	uint32_t kept = this->ROM ? this->ROMBufferSize + 0x200 + 0x8000 : 0;
+	if (kept)
+		std::copy_n(&this->RealROM[0], kept, &buffer[0]);
+	std::fill_n(&buffer[kept], size + 0x200 + 0x8000 - kept, 0);
+	this->RealROM = std::move(buffer);
+	this->ROMBufferSize = size;
 
 	// FillRAM uses first 32K of ROM image area, otherwise space just
 	// wasted. Might be read by the SuperFX code.
@@ -237,19 +295,6 @@ bool CMemory::Init()
 	// unallocated memory (can cause crash on some ports).
 
 	this->ROM = &this->RealROM[0x8000];
-
-	return true;
-}
-
-void CMemory::Deinit()
-{
-	this->RAM.reset();
-	this->SRAM.reset();
-	this->VRAM.reset();
-	this->ROM = nullptr;
-	this->RealROM.reset();
-
-	this->Safe(nullptr);
 }
 
 // file management and ROM detection
@@ -362,7 +407,11 @@ bool CMemory::LoadROMSNSF(const uint8_t *lrombuf, int32_t lromsize, const uint8_
 {
 	int retry_count = 0;
 
-	std::fill_n(&this->ROM[0], static_cast<int>(MAX_ROM_SIZE), 0);
+	// The buffer covers the image rounded up to a whole 64K bank, which is as
+	// far as the header detection and the mirrored memory maps reach.  The
+	// maps that place ROM at fixed offsets reserve more for themselves.
+	this->ReserveROM((std::min<uint32_t>(MAX_ROM_SIZE, std::max(lromsize, 1)) + 0xFFFF) & ~0xFFFF);
+	std::fill_n(&this->ROM[0], this->ROMBufferSize + 0x200, 0);
 
 again:
 	this->CalculatedSize = 0;
@@ -700,7 +749,7 @@ void CMemory::map_lorom(uint32_t bank_s, uint32_t bank_e, uint32_t addr_s, uint3
 		{
 			uint32_t p = (c << 4) | (i >> 12);
 			uint32_t addr = (c & 0x7f) * 0x8000;
-			this->Map[p] = &this->ROM[this->map_mirror(size, addr) - (i & 0x8000)];
+			this->Map[p] = &this->ROM[static_cast<int32_t>(this->map_mirror(size, addr) - (i & 0x8000))];
 			this->BlockIsROM[p] = true;
 			this->BlockIsRAM[p] = false;
 		}
@@ -726,7 +775,7 @@ void CMemory::map_lorom_offset(uint32_t bank_s, uint32_t bank_e, uint32_t addr_s
 		{
 			uint32_t p = (c << 4) | (i >> 12);
 			uint32_t addr = ((c - bank_s) & 0x7f) * 0x8000;
-			this->Map[p] = &this->ROM[offset + this->map_mirror(size, addr) - (i & 0x8000)];
+			this->Map[p] = &this->ROM[static_cast<int32_t>(offset + this->map_mirror(size, addr) - (i & 0x8000))];
 			this->BlockIsROM[p] = true;
 			this->BlockIsRAM[p] = false;
 		}
@@ -854,6 +903,7 @@ void CMemory::Map_NoMAD1LoROMMap()
 void CMemory::Map_JumboLoROMMap()
 {
 	// XXX: Which game uses this?
+	this->ReserveROM(0x600000);
 	this->map_System();
 
 	this->map_lorom_offset(0x00, 0x3f, 0x8000, 0xffff, this->CalculatedSize - 0x400000, 0x400000);
@@ -870,6 +920,7 @@ void CMemory::Map_JumboLoROMMap()
 void CMemory::Map_ROM24MBSLoROMMap()
 {
 	// PCB: BSC-1A5M-01, BSC-1A7M-10
+	this->ReserveROM(0x300000);
 	this->map_System();
 
 	this->map_lorom_offset(0x00, 0x1f, 0x8000, 0xffff, 0x100000, 0);
@@ -904,6 +955,7 @@ void CMemory::Map_SRAM512KLoROMMap()
 
 void CMemory::Map_SDD1LoROMMap()
 {
+	this->ReserveROM(MAX_ROM_SIZE);
 	this->map_System();
 
 	this->map_lorom(0x00, 0x3f, 0x8000, 0xffff, this->CalculatedSize);
@@ -239,9 +239,11 @@ struct CMemory
 	uint8_t SRAMSize;
 	uint32_t SRAMMask;
 	uint32_t CalculatedSize;
+	uint32_t ROMBufferSize;
 
 	bool Init();
 	void Deinit();
+	void ReserveROM(uint32_t);
 
 	int ScoreHiROM(bool, int32_t romoff = 0);
 	int ScoreLoROM(bool, int32_t romoff = 0);
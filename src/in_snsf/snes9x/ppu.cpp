@@ -207,6 +207,23 @@ void S9xUpdateHVTimerPosition()
 	}
 }
 
+// Loads the word the next $2139/$213A read returns.  The audio-only profile
+// has no VRAM, so those reads give 0 there.
+static inline void S9xFetchVRAMReadBuffer()
+{
+	if (!Memory.VRAM)
+		IPPU.VRAMReadBuffer = 0;
+	else if (PPU.VMA.FullGraphicCount)
+	{
+		uint32_t addr = PPU.VMA.Address;
+		uint32_t rem = addr & PPU.VMA.Mask1;
+		uint32_t address = (addr & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3);
+		IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(address << 1) & 0xffff]);
+	}
+	else
+		IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(PPU.VMA.Address << 1) & 0xffff]);
+}
+
 void S9xSetPPU(uint8_t Byte, uint16_t Address)
 {
 	// MAP_PPU: $2000-$3FFF
@@ -326,15 +343,7 @@ void S9xSetPPU(uint8_t Byte, uint16_t Address)
 				PPU.VMA.Address &= 0xff00;
 				PPU.VMA.Address |= Byte;
 
-				if (PPU.VMA.FullGraphicCount)
-				{
-					uint32_t addr = PPU.VMA.Address;
-					uint32_t rem = addr & PPU.VMA.Mask1;
-					uint32_t address = (addr & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3);
-					IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(address << 1) & 0xffff]);
-				}
-				else
-					IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(PPU.VMA.Address << 1) & 0xffff]);
+				S9xFetchVRAMReadBuffer();
 
 				break;
 
@@ -342,15 +351,7 @@ void S9xSetPPU(uint8_t Byte, uint16_t Address)
 				PPU.VMA.Address &= 0x00ff;
 				PPU.VMA.Address |= Byte << 8;
 
-				if (PPU.VMA.FullGraphicCount)
-				{
-					uint32_t addr = PPU.VMA.Address;
-					uint32_t rem = addr & PPU.VMA.Mask1;
-					uint32_t address = (addr & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3);
-					IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(address << 1) & 0xffff]);
-				}
-				else
-					IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(PPU.VMA.Address << 1) & 0xffff]);
+				S9xFetchVRAMReadBuffer();
 
 				break;
 
@@ -534,15 +535,7 @@ uint8_t S9xGetPPU(uint16_t Address)
 				byte = IPPU.VRAMReadBuffer & 0xff;
 				if (!PPU.VMA.High)
 				{
-					if (PPU.VMA.FullGraphicCount)
-					{
-						uint32_t addr = PPU.VMA.Address;
-						uint32_t rem = addr & PPU.VMA.Mask1;
-						uint32_t address = (addr & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3);
-						IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(address << 1) & 0xffff]);
-					}
-					else
-						IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(PPU.VMA.Address << 1) & 0xffff]);
+					S9xFetchVRAMReadBuffer();
 
 					PPU.VMA.Address += PPU.VMA.Increment;
 				}
@@ -552,15 +545,7 @@ uint8_t S9xGetPPU(uint16_t Address)
 				byte = (IPPU.VRAMReadBuffer >> 8) & 0xff;
 				if (PPU.VMA.High)
 				{
-					if (PPU.VMA.FullGraphicCount)
-					{
-						uint32_t addr = PPU.VMA.Address;
-						uint32_t rem = addr & PPU.VMA.Mask1;
-						uint32_t address = (addr & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3);
-						IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(address << 1) & 0xffff]);
-					}
-					else
-						IPPU.VRAMReadBuffer = READ_WORD(&Memory.VRAM[(PPU.VMA.Address << 1) & 0xffff]);
+					S9xFetchVRAMReadBuffer();
 
 					PPU.VMA.Address += PPU.VMA.Increment;
 				}
@@ -328,21 +328,26 @@ inline void REGISTER_2104(uint8_t Byt)
 // This code is correct, however due to Snes9x's inaccurate timings, some games might be broken by this chage. :(
 inline bool CHECK_INBLANK() { return Settings.BlockInvalidVRAMAccess && !PPU.ForcedBlanking && CPU.V_Counter < PPU.ScreenHeight + FIRST_VISIBLE_LINE; }
 
+// The audio-only profile has no VRAM, writes to it only move the address on
+inline void S9xWriteVRAM(uint32_t address, uint8_t Byt)
+{
+	if (Memory.VRAM)
+		Memory.VRAM[address] = Byt;
+}
+
 inline void REGISTER_2118(uint8_t Byt)
 {
 	if (CHECK_INBLANK())
 		return;
 
-	uint32_t address;
-
 	if (PPU.VMA.FullGraphicCount)
 	{
 		uint32_t rem = PPU.VMA.Address & PPU.VMA.Mask1;
-		address = (((PPU.VMA.Address & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3)) << 1) & 0xffff;
-		Memory.VRAM[address] = Byt;
+		uint32_t address = (((PPU.VMA.Address & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3)) << 1) & 0xffff;
+		S9xWriteVRAM(address, Byt);
 	}
 	else
-		Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byt;
+		S9xWriteVRAM((PPU.VMA.Address << 1) & 0xffff, Byt);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -353,16 +358,14 @@ inline void REGISTER_2119(uint8_t Byt)
 	if (CHECK_INBLANK())
 		return;
 
-	uint32_t address;
-
 	if (PPU.VMA.FullGraphicCount)
 	{
 		uint32_t rem = PPU.VMA.Address & PPU.VMA.Mask1;
-		address = ((((PPU.VMA.Address & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3)) << 1) + 1) & 0xffff;
-		Memory.VRAM[address] = Byt;
+		uint32_t address = ((((PPU.VMA.Address & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3)) << 1) + 1) & 0xffff;
+		S9xWriteVRAM(address, Byt);
 	}
 	else
-		Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byt;
+		S9xWriteVRAM(((PPU.VMA.Address << 1) + 1) & 0xffff, Byt);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -376,7 +379,7 @@ inline void REGISTER_2118_tile(uint8_t Byt)
 	uint32_t rem = PPU.VMA.Address & PPU.VMA.Mask1;
 	uint32_t address = (((PPU.VMA.Address & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3)) << 1) & 0xffff;
 
-	Memory.VRAM[address] = Byt;
+	S9xWriteVRAM(address, Byt);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -390,7 +393,7 @@ inline void REGISTER_2119_tile(uint8_t Byt)
 	uint32_t rem = PPU.VMA.Address & PPU.VMA.Mask1;
 	uint32_t address = ((((PPU.VMA.Address & ~PPU.VMA.Mask1) + (rem >> PPU.VMA.Shift) + ((rem & (PPU.VMA.FullGraphicCount - 1)) << 3)) << 1) + 1) & 0xffff;
 
-	Memory.VRAM[address] = Byt;
+	S9xWriteVRAM(address, Byt);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -401,9 +404,7 @@ inline void REGISTER_2118_linear(uint8_t Byt)
 	if (CHECK_INBLANK())
 		return;
 
-	uint32_t address;
-
-	Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byt;
+	S9xWriteVRAM((PPU.VMA.Address << 1) & 0xffff, Byt);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -414,9 +415,7 @@ inline void REGISTER_2119_linear(uint8_t Byt)
 	if (CHECK_INBLANK())
 		return;
 
-	uint32_t address;
-
-	Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byt;
+	S9xWriteVRAM(((PPU.VMA.Address << 1) + 1) & 0xffff, Byt);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
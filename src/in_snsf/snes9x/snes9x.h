@@ -281,12 +281,11 @@ struct SSettings
 	bool PAL;
 
 	bool SoundSync;
-	bool SixteenBitSound;
 	uint32_t SoundPlaybackRate;
 	uint32_t SoundInputRate;
-	bool Stereo;
+	uint32_t SoundResamplerPhases;
 	bool ReverseStereo;
-	bool Mute;
+	bool AudioOnly;
 
 	bool DisableGameSpecificHacks;
 	bool BlockInvalidVRAMAccessMaster;
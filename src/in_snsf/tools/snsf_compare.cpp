@@ -0,0 +1,245 @@
+/*
+ * xSF - SNSF engine comparison tool
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Renders an SNSF with full emulation and again with the audio-only profile,
+ * which is meant to come out identical, down to what is left in WRAM, then
+ * reports the signal-to-noise ratio of the audio-only render against the full
+ * one. A built-in image that waits for H-blank on every line is run before
+ * any files.
+ *
+ * Usage: snsf_compare [-s seconds] [-r rate] [-t minimum SNR in dB] [file...]
+ *
+ * The exit status is 1 if any file fails to load, ends with different WRAM or
+ * (with -t) comes out below the minimum SNR, so the tool can be run over a
+ * whole set.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "XSFFile.h"
+#include "../SNSFLoader.h"
+
+#undef min
+#undef max
+
+#include "../snes9x/snes9x.h"
+#include "../snes9x/memmap.h"
+#include "../snes9x/cpuexec.h"
+#include "../snes9x/apu/apu.h"
+#include "../snes9x/apu/linear_resampler.h"
+
+bool S9xOpenSoundDevice()
+{
+	return true;
+}
+
+// The snes9x settings a render differs in
+struct Profile
+{
+	const char *name;
+	bool audioOnly;
+};
+
+static const Profile reference = { "cycle-exact", false }, audioOnly = { "audio-only", true };
+
+// What a render leaves behind, WRAM is empty if the ROM did not load
+struct Rendering
+{
+	std::vector<int16_t> samples;
+	std::vector<uint8_t> ram;
+};
+
+static Rendering Render(const SNSFImage &image, const Profile &profile, unsigned sampleRate, unsigned seconds)
+{
+	// Settings is a zeroed global and loading the ROM sets the fields that depend on it, only what a render needs is set here
+	Settings.SoundSync = true;
+	Settings.SoundPlaybackRate = sampleRate;
+	Settings.AudioOnly = profile.audioOnly;
+
+	Rendering rendering;
+	auto &samples = rendering.samples;
+	Memory.Init();
+	S9xInitAPU();
+	S9xInitSound<LinearResampler>(10, 0);
+	if (Memory.LoadROMSNSF(&image.rom[0], image.rom.size(), image.sram.empty() ? nullptr : &image.sram[0], image.sram.size()))
+	{
+		size_t total = static_cast<size_t>(sampleRate) * seconds * 2;
+		samples.reserve(total + sampleRate);
+		while (samples.size() < total)
+		{
+			S9xSyncSound();
+			S9xMainLoop();
+			int count = S9xGetSampleCount() & ~1;
+			if (!count)
+				continue;
+			size_t filled = samples.size();
+			samples.resize(filled + count, 0);
+			S9xMixSamples(reinterpret_cast<uint8_t *>(&samples[filled]), count);
+		}
+		samples.resize(total);
+		rendering.ram.assign(&Memory.RAM[0], &Memory.RAM[0x20000]);
+	}
+	S9xReset();
+	Memory.Deinit();
+	S9xDeinitAPU();
+
+	return rendering;
+}
+
+static double SNR(double signal, double noise)
+{
+	if (noise <= 0.0)
+		return HUGE_VAL;
+	if (signal <= 0.0)
+		return -HUGE_VAL;
+	return 10.0 * std::log10(signal / noise);
+}
+
+// Returns the overall SNR in dB
+static double Compare(const std::vector<int16_t> &exact, const std::vector<int16_t> &test, unsigned sampleRate)
+{
+	double signal[2] = { 0.0, 0.0 }, noise[2] = { 0.0, 0.0 };
+	int peak = 0;
+	size_t firstDifference = exact.size();
+	for (size_t i = 0, count = exact.size(); i < count; ++i)
+	{
+		int difference = test[i] - exact[i];
+		if (difference && firstDifference == count)
+			firstDifference = i;
+		peak = std::max(peak, std::abs(difference));
+		signal[i & 1] += static_cast<double>(exact[i]) * exact[i];
+		noise[i & 1] += static_cast<double>(difference) * difference;
+	}
+
+	double overall = SNR(signal[0] + signal[1], noise[0] + noise[1]);
+	std::printf("  SNR L %.2f dB, R %.2f dB, overall %.2f dB, peak error %d\n", SNR(signal[0], noise[0]), SNR(signal[1], noise[1]), overall, peak);
+	if (firstDifference == exact.size())
+		std::printf("  identical\n");
+	else
+		std::printf("  first difference at %.3f s\n", static_cast<double>(firstDifference / 2) / sampleRate);
+	return overall;
+}
+
+// A LoROM image that waits for the start of H-blank on every line in a
+// BIT $4212 / BVC loop, which the idle loop skipping fast-forwards, then
+// counts the passes of a loop that cannot be skipped until H-blank ends and
+// stores the count in WRAM.  A delay that changes from line to line starts
+// the wait at a different point each time, and leaving it even one pass late
+// or early changes the counts.
+static SNSFImage HBlankPollImage()
+{
+	static const uint8_t program[] =
+	{
+		0x78, 0x18, 0xFB, // sei, clc, xce
+		0xA2, 0x00, // ldx #$00
+		0x8A, 0x29, 0x0F, 0xA8, // next: txa, and #$0F, tay
+		0x88, 0x10, 0xFD, // dey, bpl (delay by X & 15)
+		0xA0, 0x00, // ldy #$00
+		0x2C, 0x12, 0x42, 0x70, 0xFB, // bit $4212, bvs (until H-blank ends)
+		0x2C, 0x12, 0x42, 0x50, 0xFB, // bit $4212, bvc (until it starts again)
+		0xC8, 0x2C, 0x12, 0x42, 0x70, 0xFA, // iny, bit $4212, bvs
+		0x98, 0x9D, 0x00, 0x02, // tya, sta $0200,x
+		0xE8, 0x80, 0xE0 // inx, bra next
+	};
+	static const char title[] = "SNSF_COMPARE HBLANK  ";
+
+	SNSFImage image;
+	auto &rom = image.rom;
+	rom.resize(0x8000, 0);
+	std::copy_n(program, sizeof(program), &rom[0]);
+	std::copy_n(title, 21, &rom[0x7FC0]);
+	rom[0x7FD5] = 0x20; // LoROM
+	rom[0x7FD7] = 0x05; // 32 KB
+	rom[0x7FD9] = 0x01; // North America
+	rom[0x7FDA] = 0x33;
+	rom[0x7FFD] = rom[0x7FFB] = rom[0x7FEB] = 0x80; // reset and NMI at $8000
+	rom[0x7FDC] = rom[0x7FDD] = 0xFF;
+	unsigned checksum = 0;
+	for (auto byte : rom)
+		checksum += byte;
+	rom[0x7FDE] = checksum & 0xFF;
+	rom[0x7FDF] = (checksum >> 8) & 0xFF;
+	rom[0x7FDC] = ~checksum & 0xFF;
+	rom[0x7FDD] = (~checksum >> 8) & 0xFF;
+	return image;
+}
+
+// Returns false if the image fails to load or, by the given criteria, to match
+static bool CompareImage(const char *name, const SNSFImage &image, unsigned sampleRate, unsigned seconds, double minimumSNR)
+{
+	std::printf("%s: %s vs %s, %u s at %u Hz\n", name, reference.name, audioOnly.name, seconds, sampleRate);
+	auto exact = Render(image, reference, sampleRate, seconds);
+	auto test = Render(image, audioOnly, sampleRate, seconds);
+	if (exact.samples.empty() || test.samples.empty())
+	{
+		std::printf("  unable to load the ROM\n");
+		return false;
+	}
+	bool matched = Compare(exact.samples, test.samples, sampleRate) >= minimumSNR;
+	auto difference = std::mismatch(exact.ram.begin(), exact.ram.end(), test.ram.begin());
+	if (difference.first == exact.ram.end())
+		std::printf("  WRAM identical\n");
+	else
+	{
+		std::printf("  WRAM differs from $%06X\n", static_cast<unsigned>(0x7E0000 + (difference.first - exact.ram.begin())));
+		matched = false;
+	}
+	return matched;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned seconds = 60, sampleRate = 32000;
+	double minimumSNR = -HUGE_VAL;
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; ++i)
+	{
+		if (i + 1 < argc && !std::strcmp(argv[i], "-s"))
+			seconds = std::strtoul(argv[++i], nullptr, 10);
+		else if (i + 1 < argc && !std::strcmp(argv[i], "-r"))
+			sampleRate = std::strtoul(argv[++i], nullptr, 10);
+		else if (i + 1 < argc && !std::strcmp(argv[i], "-t"))
+			minimumSNR = std::strtod(argv[++i], nullptr);
+		else
+			break;
+	}
+	if ((i < argc && argv[i][0] == '-') || !seconds || !sampleRate)
+	{
+		std::fprintf(stderr, "Usage: %s [-s seconds] [-r rate] [-t minimum SNR in dB] [file...]\n", argv[0]);
+		return 2;
+	}
+
+	int result = 0;
+	if (!CompareImage("built-in $4212 H-blank poll", HBlankPollImage(), sampleRate, seconds, minimumSNR))
+		result = 1;
+	for (; i < argc; ++i)
+	{
+		SNSFImage image;
+		try
+		{
+			auto xSF = std::make_unique<XSFFile>(argv[i], 4, 8);
+			if (!image.Load(xSF.get()) || image.rom.empty())
+				throw std::runtime_error("not a valid SNSF");
+		}
+		catch (const std::exception &e)
+		{
+			std::printf("%s: unable to load: %s\n", argv[i], e.what());
+			result = 1;
+			continue;
+		}
+
+		if (!CompareImage(argv[i], image, sampleRate, seconds, minimumSNR))
+			result = 1;
+	}
+
+	return result;
+}
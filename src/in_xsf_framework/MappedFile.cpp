@@ -0,0 +1,108 @@
+/*
+ * xSF - Memory-mapped file
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Read-only memory mapping of a file on disk.
+ */
+
+#include "MappedFile.h"
+#include "convert.h"
+#ifdef _WIN32
+# include "windowsh_wrapper.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string &filename) : data(nullptr), size(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+{
+	this->Open(ConvertFuncs::StringToWString(filename));
+}
+
+MappedFile::MappedFile(const std::wstring &filename) : data(nullptr), size(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+{
+	this->Open(filename);
+}
+
+void MappedFile::Open(const std::wstring &filename)
+{
+	// Sharing is kept as open as possible so that tags can still be written to a file that is being played.
+	this->fileHandle = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (this->fileHandle == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Unable to open file " + ConvertFuncs::WStringToString(filename) + ".");
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(this->fileHandle, &fileSize))
+	{
+		CloseHandle(this->fileHandle);
+		throw std::runtime_error("Unable to get the size of file " + ConvertFuncs::WStringToString(filename) + ".");
+	}
+	this->size = static_cast<size_t>(fileSize.QuadPart);
+
+	// Mapping an empty file is not allowed, so an empty file just gets an empty view.
+	if (!this->size)
+		return;
+
+	this->mappingHandle = CreateFileMappingW(this->fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (this->mappingHandle)
+		this->data = static_cast<const uint8_t *>(MapViewOfFile(this->mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!this->data)
+	{
+		if (this->mappingHandle)
+			CloseHandle(this->mappingHandle);
+		CloseHandle(this->fileHandle);
+		throw std::runtime_error("Unable to map file " + ConvertFuncs::WStringToString(filename) + ".");
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (this->data)
+		UnmapViewOfFile(this->data);
+	if (this->mappingHandle)
+		CloseHandle(this->mappingHandle);
+	if (this->fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(this->fileHandle);
+}
+#else
+MappedFile::MappedFile(const std::string &filename) : data(nullptr), size(0)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw std::runtime_error("Unable to open file " + filename + ".");
+
+	struct stat st;
+	if (fstat(fd, &st) == -1)
+	{
+		close(fd);
+		throw std::runtime_error("Unable to get the size of file " + filename + ".");
+	}
+	this->size = static_cast<size_t>(st.st_size);
+
+	// Mapping an empty file is not allowed, so an empty file just gets an empty view.
+	if (this->size)
+	{
+		void *mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED)
+		{
+			close(fd);
+			throw std::runtime_error("Unable to map file " + filename + ".");
+		}
+		this->data = static_cast<const uint8_t *>(mapping);
+	}
+
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if (this->data)
+		munmap(const_cast<uint8_t *>(this->data), this->size);
+}
+#endif
@@ -1,65 +1,84 @@
 /*
  * xSF Tag List
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2013-03-25
+ * Last modification on 2026-10-19
  *
  * Storage of tags from PSF-style files, specifications found at
  * http://wiki.neillcorlett.com/PSFTagFormat
  */
 
-#include <algorithm>
 #include "TagList.h"
 
-eq_str TagList::eqstr;
+auto TagList::FindTag(const TagKey &name) const -> const Tag *
+{
+	auto hash = name.GetHash();
+	auto nameStr = name.GetName();
+	for (auto curr = this->tags.begin(), end = this->tags.end(); curr != end; ++curr)
+		if (curr->hash == hash && TagKey::Equals(curr->name, nameStr))
+			return &*curr;
+	return nullptr;
+}
 
-auto TagList::GetKeys() const -> const TagsList &
+auto TagList::GetKeys() const -> TagsList
 {
-	return this->tagsOrder;
+	TagsList keys;
+	keys.reserve(this->tags.size());
+	for (auto curr = this->tags.begin(), end = this->tags.end(); curr != end; ++curr)
+		keys.push_back(curr->name);
+	return keys;
 }
 
 auto TagList::GetTags() const -> TagsList
 {
 	TagsList allTags;
-	for (auto curr = this->tagsOrder.begin(), end = this->tagsOrder.end(); curr != end; ++curr)
-		allTags.push_back(*curr + "=" + this->tags.find(*curr)->second);
+	allTags.reserve(this->tags.size());
+	for (auto curr = this->tags.begin(), end = this->tags.end(); curr != end; ++curr)
+		allTags.push_back(curr->name + "=" + curr->value);
 	return allTags;
 }
 
-bool TagList::Exists(const std::string &name) const
+bool TagList::Exists(const TagKey &name) const
+{
+	return !!this->FindTag(name);
+}
+
+// Gets a pointer to the value of the tag, or nullptr if the tag does not exist, without copying the value
+const std::string *TagList::Find(const TagKey &name) const
 {
-	return std::find_if(this->tagsOrder.begin(), this->tagsOrder.end(), std::bind2nd(TagList::eqstr, name)) != this->tagsOrder.end();
+	auto tag = this->FindTag(name);
+	return tag ? &tag->value : nullptr;
 }
 
-std::string TagList::operator[](const std::string &name) const
+std::string_view TagList::operator[](const TagKey &name) const
 {
-	auto tag = this->tags.find(name);
-	if (tag == this->tags.end())
-		return "";
-	return tag->second;
+	auto tag = this->FindTag(name);
+	if (!tag)
+		return std::string_view();
+	return tag->value;
 }
 
-std::string &TagList::operator[](const std::string &name)
+std::string &TagList::operator[](const TagKey &name)
 {
-	auto tag = std::find_if(this->tagsOrder.begin(), this->tagsOrder.end(), std::bind2nd(TagList::eqstr, name));
-	if (tag == this->tagsOrder.end())
+	auto tag = const_cast<Tag *>(this->FindTag(name));
+	if (!tag)
 	{
-		this->tagsOrder.push_back(name);
-		this->tags[name] = "";
+		// Most files have somewhere around a dozen tags, so this avoids regrowing the vector for nearly all of them
+		if (this->tags.empty())
+			this->tags.reserve(16);
+		this->tags.push_back({ name.GetHash(), std::string(name.GetName()), "" });
+		tag = &this->tags.back();
 	}
-	return this->tags[name];
+	return tag->value;
 }
 
-void TagList::Remove(const std::string &name)
+void TagList::Remove(const TagKey &name)
 {
-	auto tagOrder = std::find_if(this->tagsOrder.begin(), this->tagsOrder.end(), std::bind2nd(TagList::eqstr, name));
-	if (tagOrder != this->tagsOrder.end())
-		this->tagsOrder.erase(tagOrder);
-	if (this->tags.count(name))
-		this->tags.erase(name);
+	auto tag = this->FindTag(name);
+	if (tag)
+		this->tags.erase(this->tags.begin() + (tag - &this->tags[0]));
 }
 
 void TagList::Clear()
 {
-	this->tagsOrder.clear();
 	this->tags.clear();
 }
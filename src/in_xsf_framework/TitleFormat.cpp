@@ -0,0 +1,151 @@
+/*
+ * xSF - Title formatting
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * A title format string, compiled once into a list of operations so it can be
+ * applied to the tags of any number of files without being parsed again.
+ */
+
+#include "TitleFormat.h"
+
+TitleFormat::TitleFormat(const std::string &format) : literals(), tagNames(), tagHashes(), ops()
+{
+	this->Compile(format, 0, format.length(), 0);
+}
+
+void TitleFormat::AddLiteral(char c)
+{
+	// Consecutive literal characters are merged into a single operation
+	if (this->ops.empty() || this->ops.back().code != OP_LITERAL)
+	{
+		Op op = { OP_LITERAL, this->literals.length(), 0 };
+		this->ops.push_back(op);
+	}
+	this->literals += c;
+	++this->ops.back().length;
+}
+
+void TitleFormat::AddTag(const std::string &name)
+{
+	Op op = { OP_TAG, this->tagNames.size(), 0 };
+	this->ops.push_back(op);
+	this->tagNames.push_back(name);
+	this->tagHashes.push_back(TagKey::Hash(name));
+}
+
+// Level 0 is the top level of the format, anything higher is within an optional block.
+// An unterminated tag or optional block drops the remainder of whatever level it is in.
+void TitleFormat::Compile(const std::string &format, size_t start, size_t end, unsigned level)
+{
+	for (size_t x = start; x < end; ++x)
+	{
+		char c = format[x];
+		if (c == '%')
+		{
+			size_t origX = x;
+			for (++x; x < end; ++x)
+				if (format[x] == '%')
+					break;
+			if (x != end)
+				this->AddTag(format.substr(origX + 1, x - origX - 1));
+			continue;
+		}
+		if (c == '[' && level < TitleFormat::MaxBlockLevel)
+		{
+			size_t origX = x;
+			unsigned nests = 0;
+			for (++x; x < end; ++x)
+			{
+				if (format[x] == '[')
+					++nests;
+				else if (format[x] == ']')
+				{
+					if (!nests)
+						break;
+					--nests;
+				}
+			}
+			if (x != end)
+			{
+				Op blockStart = { OP_BLOCK_START, 0, 0 }, blockEnd = { OP_BLOCK_END, 0, 0 };
+				this->ops.push_back(blockStart);
+				this->Compile(format, origX + 1, x, level + 1);
+				this->ops.push_back(blockEnd);
+			}
+			continue;
+		}
+		this->AddLiteral(c);
+	}
+}
+
+// The output only needs to be able to append, tell where it is, and go back to an earlier position.
+// This way the same code measures the final length and then writes the final string.
+struct TitleFormatLength
+{
+	size_t length;
+
+	TitleFormatLength() : length(0) { }
+	void Append(const char *, size_t len) { this->length += len; }
+	size_t Position() const { return this->length; }
+	void Rewind(size_t position) { this->length = position; }
+};
+
+struct TitleFormatString
+{
+	std::string &str;
+
+	TitleFormatString(std::string &s) : str(s) { }
+	void Append(const char *s, size_t len) { this->str.append(s, len); }
+	size_t Position() const { return this->str.length(); }
+	void Rewind(size_t position) { this->str.resize(position); }
+};
+
+template<typename Output> void TitleFormat::Evaluate(const TagList &tags, Output &output) const
+{
+	// Only the tags directly within a block decide if the block is kept, the tags of a nested block do not count towards it
+	size_t blockPosition[TitleFormat::MaxBlockLevel + 1];
+	bool blockHadReplacement[TitleFormat::MaxBlockLevel + 1];
+	unsigned level = 0;
+	for (auto op = this->ops.begin(), end = this->ops.end(); op != end; ++op)
+	{
+		switch (op->code)
+		{
+			case OP_LITERAL:
+				output.Append(&this->literals[op->start], op->length);
+				break;
+			case OP_TAG:
+			{
+				auto value = tags.Find(TagKey(this->tagNames[op->start], this->tagHashes[op->start]));
+				if (value && !value->empty())
+				{
+					output.Append(value->c_str(), value->length());
+					blockHadReplacement[level] = true;
+				}
+				else if (!level)
+					output.Append("???", 3);
+				break;
+			}
+			case OP_BLOCK_START:
+				++level;
+				blockPosition[level] = output.Position();
+				blockHadReplacement[level] = false;
+				break;
+			case OP_BLOCK_END:
+				if (!blockHadReplacement[level])
+					output.Rewind(blockPosition[level]);
+				--level;
+		}
+	}
+}
+
+std::string TitleFormat::Format(const TagList &tags) const
+{
+	TitleFormatLength length;
+	this->Evaluate(tags, length);
+	std::string formatted;
+	formatted.reserve(length.length);
+	TitleFormatString output(formatted);
+	this->Evaluate(tags, output);
+	return formatted;
+}
@@ -0,0 +1,93 @@
+/*
+ * xSF - Virtual files
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * A read-only file that is either a file on disk or a member of a zip archive.
+ */
+
+#include <map>
+#include <mutex>
+#include "VirtualFile.h"
+#include "MappedFile.h"
+#include "ZipArchive.h"
+#include "convert.h"
+#include "eqstr.h"
+#ifdef _WIN32
+# include "windowsh_wrapper.h"
+#else
+# include <sys/stat.h>
+#endif
+
+static bool IsRegularFile(const std::string &path)
+{
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesW(ConvertFuncs::StringToWString(path).c_str());
+	return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+	struct stat st;
+	return !stat(path.c_str(), &st) && S_ISREG(st.st_mode);
+#endif
+}
+
+// Splits a path such as C:\Music\Set.zip\01.minigsf into the archive and the name of the member within it.
+// Only the path components ending in .zip are checked, so a path that doesn't exist doesn't cost a check of every directory in it.
+static bool SplitArchivePath(const std::string &path, std::string &archivePath, std::string &memberName)
+{
+	eq_str equals;
+	for (size_t sep = path.find_first_of("\\/"); sep != std::string::npos; sep = path.find_first_of("\\/", sep + 1))
+	{
+		if (sep < 4 || !equals(path.substr(sep - 4, 4), ".zip"))
+			continue;
+		auto prefix = path.substr(0, sep);
+		if (IsRegularFile(prefix))
+		{
+			archivePath = prefix;
+			memberName = path.substr(sep + 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Loading a set opens the same archive once for each of its files and libraries, so an archive is kept open and reused for as long
+// as any member opened from it is still open. The cache is shared between the playback thread and Winamp's metadata thread.
+static std::shared_ptr<const ZipArchive> GetArchive(const std::string &archivePath)
+{
+	static std::mutex cacheMutex;
+	static std::map<std::string, std::weak_ptr<const ZipArchive>> cache;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto archive = cache[archivePath].lock();
+	if (!archive)
+	{
+		for (auto curr = cache.begin(); curr != cache.end(); )
+		{
+			if (curr->second.expired() && curr->first != archivePath)
+				curr = cache.erase(curr);
+			else
+				++curr;
+		}
+		archive.reset(new ZipArchive(archivePath));
+		cache[archivePath] = archive;
+	}
+	return archive;
+}
+
+std::shared_ptr<const VirtualFile> VirtualFile::Open(const std::string &path)
+{
+	if (IsRegularFile(path))
+		return std::shared_ptr<const VirtualFile>(new MappedFile(path));
+
+	std::string archivePath, memberName;
+	if (SplitArchivePath(path, archivePath, memberName))
+		return GetArchive(archivePath)->OpenMember(memberName);
+
+	throw std::logic_error("File " + path + " does not exist.");
+}
+
+bool VirtualFile::IsArchiveMember(const std::string &path)
+{
+	std::string archivePath, memberName;
+	return !IsRegularFile(path) && SplitArchivePath(path, archivePath, memberName);
+}
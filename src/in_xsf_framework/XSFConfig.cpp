@@ -1,7 +1,7 @@
 /*
  * xSF - Core configuration handler
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-10-05
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  */
@@ -43,7 +43,7 @@ VolumeType XSFConfig::initVolumeType = VOLUMETYPE_REPLAYGAIN_ALBUM;
 PeakType XSFConfig::initPeakType = PEAKTYPE_REPLAYGAIN_TRACK;
 
 XSFConfig::XSFConfig() : playInfinitely(false), skipSilenceOnStartSec(0), detectSilenceSec(0), defaultLength(0), defaultFade(0), volume(0.0), volumeType(VOLUMETYPE_NONE), peakType(PEAKTYPE_NONE),
-	sampleRate(0), titleFormat(""), configDialog(), configDialogProperty(), infoDialog(), supportedSampleRates(), configIO(XSFConfigIO::Create())
+	sampleRate(0), titleFormat(""), compiledTitleFormat(), configDialog(), configDialogProperty(), infoDialog(), supportedSampleRates(), configIO(XSFConfigIO::Create())
 {
 }
 
@@ -73,6 +73,7 @@ void XSFConfig::LoadConfig()
 	this->peakType = static_cast<PeakType>(this->configIO->GetValue("PeakType", static_cast<int>(XSFConfig::initPeakType)));
 	this->sampleRate = this->configIO->GetValue("SampleRate", XSFConfig::initSampleRate);
 	this->titleFormat = this->configIO->GetValue("TitleFormat", XSFConfig::initTitleFormat);
+	this->compiledTitleFormat = TitleFormat(this->titleFormat);
 
 	this->LoadSpecificConfig();
 }
@@ -283,13 +284,13 @@ INT_PTR CALLBACK XSFConfig::InfoDialogProc(HWND hwndDlg, UINT uMsg, WPARAM wPara
 			break;
 		case WM_INITDIALOG:
 			SetWindowTextW(hwndDlg, ConvertFuncs::StringToWString(xSFFileInInfo->GetFilename()).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoTitle), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("title")).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoArtist), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("artist")).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoGame), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("game")).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoYear), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("year")).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoGenre), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("genre")).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoCopyright), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("copyright")).c_str());
-			SetWindowTextW(GetDlgItem(hwndDlg, idInfoComment), ConvertFuncs::StringToWString(xSFFileInInfo->GetTagValue("comment")).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoTitle), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("title"))).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoArtist), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("artist"))).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoGame), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("game"))).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoYear), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("year"))).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoGenre), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("genre"))).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoCopyright), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("copyright"))).c_str());
+			SetWindowTextW(GetDlgItem(hwndDlg, idInfoComment), ConvertFuncs::StringToWString(std::string(xSFFileInInfo->GetTagValue("comment"))).c_str());
 			break;
 		case WM_COMMAND:
 			switch (GET_WM_COMMAND_ID(wParam, lParam))
@@ -358,6 +359,7 @@ void XSFConfig::SaveConfigDialog(HWND hwndDlg)
 	this->peakType = static_cast<PeakType>(SendMessageW(GetDlgItem(hwndDlg, idClipProtect), CB_GETCURSEL, 0, 0));
 	this->sampleRate = XSFConfig::supportedSampleRates[SendMessageW(GetDlgItem(hwndDlg, idSampleRate), CB_GETCURSEL, 0, 0)];
 	this->titleFormat = ConvertFuncs::WStringToString(this->GetTextFromWindow(GetDlgItem(hwndDlg, idTitleFormat)));
+	this->compiledTitleFormat = TitleFormat(this->titleFormat);
 
 	this->SaveSpecificConfigDialog(hwndDlg);
 }
@@ -424,3 +426,8 @@ const std::string &XSFConfig::GetTitleFormat() const
 {
 	return this->titleFormat;
 }
+
+const TitleFormat &XSFConfig::GetCompiledTitleFormat() const
+{
+	return this->compiledTitleFormat;
+}
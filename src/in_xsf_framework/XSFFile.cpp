@@ -1,18 +1,26 @@
 /*
  * xSF - File structure
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-09-24
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  */
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <functional>
 #include <stdexcept>
 #include <zlib.h>
 #include "XSFFile.h"
 #include "XSFCommon.h"
 #include "convert.h"
+#ifdef _WIN32
+# include <io.h>
+# include "windowsh_wrapper.h"
+#else
+# include <unistd.h>
+#endif
 
 static inline void Set32BitsLE(uint32_t input, uint8_t *output)
 {
@@ -50,27 +58,27 @@ static inline std::string TrimWhitespace(const std::string &orig)
 	return LeftTrimWhitespace(RightTrimWhitespace(orig));
 }
 
-XSFFile::XSFFile() : xSFType(0), hasFile(false), rawData(), reservedSection(), programSection(), tags(), fileName("")
+XSFFile::XSFFile() : xSFType(0), hasFile(false), header(), virtualFile(), rawDataView(), reservedSectionView(), rawData(), reservedSection(), programSection(), tags(), fileName("")
 {
 }
 
-XSFFile::XSFFile(const std::string &filename) : xSFType(0), hasFile(false), rawData(), reservedSection(), programSection(), tags(), fileName(filename)
+XSFFile::XSFFile(const std::string &filename) : xSFType(0), hasFile(false), header(), virtualFile(), rawDataView(), reservedSectionView(), rawData(), reservedSection(), programSection(), tags(), fileName(filename)
 {
 	this->ReadXSF(filename, 0, 0, true);
 }
 
-XSFFile::XSFFile(const std::string &filename, uint32_t programSizeOffset, uint32_t programHeaderSize) : xSFType(0), hasFile(false), rawData(), reservedSection(), programSection(), tags(), fileName(filename)
+XSFFile::XSFFile(const std::string &filename, uint32_t programSizeOffset, uint32_t programHeaderSize) : xSFType(0), hasFile(false), header(), virtualFile(), rawDataView(), reservedSectionView(), rawData(), reservedSection(), programSection(), tags(), fileName(filename)
 {
 	this->ReadXSF(filename, programSizeOffset, programHeaderSize);
 }
 
 #ifdef _WIN32
-XSFFile::XSFFile(const std::wstring &filename) : xSFType(0), hasFile(false), rawData(), reservedSection(), programSection(), tags(), fileName(ConvertFuncs::WStringToString(filename))
+XSFFile::XSFFile(const std::wstring &filename) : xSFType(0), hasFile(false), header(), virtualFile(), rawDataView(), reservedSectionView(), rawData(), reservedSection(), programSection(), tags(), fileName(ConvertFuncs::WStringToString(filename))
 {
 	this->ReadXSF(filename, 0, 0, true);
 }
 
-XSFFile::XSFFile(const std::wstring &filename, uint32_t programSizeOffset, uint32_t programHeaderSize) : xSFType(0), hasFile(false), rawData(), reservedSection(), programSection(), tags(), fileName(ConvertFuncs::WStringToString(filename))
+XSFFile::XSFFile(const std::wstring &filename, uint32_t programSizeOffset, uint32_t programHeaderSize) : xSFType(0), hasFile(false), header(), virtualFile(), rawDataView(), reservedSectionView(), rawData(), reservedSection(), programSection(), tags(), fileName(ConvertFuncs::WStringToString(filename))
 {
 	this->ReadXSF(filename, programSizeOffset, programHeaderSize);
 }
@@ -78,153 +86,122 @@ XSFFile::XSFFile(const std::wstring &filename, uint32_t programSizeOffset, uint3
 
 void XSFFile::ReadXSF(const std::string &filename, uint32_t programSizeOffset, uint32_t programHeaderSize, bool readTagsOnly)
 {
-	if (!FileExists(filename))
-		throw std::logic_error("File " + filename + " does not exist.");
-
-	std::ifstream xSF;
-	xSF.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	xSF.open(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+	this->virtualFile = VirtualFile::Open(filename);
 
-	this->ReadXSF(xSF, programSizeOffset, programHeaderSize, readTagsOnly);
-
-	xSF.close();
+	this->ReadXSF(programSizeOffset, programHeaderSize, readTagsOnly);
 }
 
 #ifdef _WIN32
 void XSFFile::ReadXSF(const std::wstring &filename, uint32_t programSizeOffset, uint32_t programHeaderSize, bool readTagsOnly)
 {
-	if (!FileExists(filename))
-		throw std::logic_error("File " + ConvertFuncs::WStringToString(filename) + " does not exist.");
-
-#if defined(_WIN32) && !defined(_MSC_VER)
-	ifstream_wfopen xSF;
-#else
-	std::ifstream xSF;
-#endif
-	xSF.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	xSF.open(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+	this->virtualFile = VirtualFile::Open(ConvertFuncs::WStringToString(filename));
 
-	this->ReadXSF(xSF, programSizeOffset, programHeaderSize, readTagsOnly);
-
-	xSF.close();
+	this->ReadXSF(programSizeOffset, programHeaderSize, readTagsOnly);
 }
 #endif
 
-void XSFFile::ReadXSF(std::ifstream &xSF, uint32_t programSizeOffset, uint32_t programHeaderSize, bool readTagsOnly)
+void XSFFile::ReadXSF(uint32_t programSizeOffset, uint32_t programHeaderSize, bool readTagsOnly)
 {
-	xSF.seekg(0, std::ifstream::end);
-	auto filesize = xSF.tellg();
-	xSF.seekg(0, std::ifstream::beg);
+	auto xSF = this->virtualFile->GetView();
+	size_t filesize = xSF.size();
 
 	if (filesize < 4)
 		throw std::runtime_error("File is too small.");
 
-	char PSFHeader[4];
-	xSF.read(PSFHeader, 4);
-
-	if (PSFHeader[0] != 'P' || PSFHeader[1] != 'S' || PSFHeader[2] != 'F')
+	if (xSF[0] != 'P' || xSF[1] != 'S' || xSF[2] != 'F')
 		throw std::runtime_error("Not a PSF file.");
 
-	this->xSFType = PSFHeader[3];
-
-	this->rawData.resize(4);
-	memcpy(&this->rawData[0], PSFHeader, 4);
+	this->xSFType = xSF[3];
 
 	if (filesize < 16)
 		throw std::runtime_error("File is too small.");
 
-	uint32_t reservedSize = Get32BitsLE(xSF), programCompressedSize = Get32BitsLE(xSF);
-	this->rawData.resize(reservedSize + programCompressedSize + 16);
-	Set32BitsLE(reservedSize, &this->rawData[4]);
-	Set32BitsLE(programCompressedSize, &this->rawData[8]);
-	xSF.read(reinterpret_cast<char *>(&this->rawData[12]), 4);
+	memcpy(this->header, xSF.data(), 16);
 
-	if (reservedSize)
-	{
-		if (filesize < reservedSize + 16)
-			throw std::runtime_error("File is too small.");
+	uint32_t reservedSize = Get32BitsLE(&xSF[4]), programCompressedSize = Get32BitsLE(&xSF[8]);
 
-		if (readTagsOnly)
-			xSF.read(reinterpret_cast<char *>(&this->rawData[16]), reservedSize);
-		else
-		{
-			this->reservedSection.resize(reservedSize);
-			xSF.read(reinterpret_cast<char *>(&this->reservedSection[0]), reservedSize);
-			memcpy(&this->rawData[16], &this->reservedSection[0], reservedSize);
-		}
-	}
+	if (filesize < 16ULL + reservedSize)
+		throw std::runtime_error("File is too small.");
 
-	if (programCompressedSize)
-	{
-		if (filesize < reservedSize + programCompressedSize + 16)
-			throw std::runtime_error("File is too small.");
+	if (!readTagsOnly)
+		this->reservedSectionView = xSF.Subview(16, reservedSize);
 
-		if (readTagsOnly)
-			xSF.read(reinterpret_cast<char *>(&this->rawData[reservedSize + 16]), programCompressedSize);
-		else
-		{
-			auto programSectionCompressed = std::vector<uint8_t>(programCompressedSize);
-			xSF.read(reinterpret_cast<char *>(&programSectionCompressed[0]), programCompressedSize);
-			memcpy(&this->rawData[reservedSize + 16], &programSectionCompressed[0], programCompressedSize);
-
-			auto programSectionUncompressed = std::vector<uint8_t>(programHeaderSize);
-			unsigned long programUncompressedSize = programHeaderSize;
-			uncompress(&programSectionUncompressed[0], &programUncompressedSize, &programSectionCompressed[0], programCompressedSize);
-			programUncompressedSize = Get32BitsLE(&programSectionUncompressed[programSizeOffset]) + programHeaderSize;
-			this->programSection.resize(programUncompressedSize);
-			uncompress(&this->programSection[0], &programUncompressedSize, &programSectionCompressed[0], programCompressedSize);
-		}
+	if (filesize < 16ULL + reservedSize + programCompressedSize)
+		throw std::runtime_error("File is too small.");
+
+	size_t endOfProgram = 16 + reservedSize + programCompressedSize;
+	this->rawDataView = xSF.Subview(0, endOfProgram);
+
+	if (programCompressedSize && !readTagsOnly)
+	{
+		auto programSectionCompressed = xSF.Subview(reservedSize + 16, programCompressedSize);
+
+		auto programSectionUncompressed = std::vector<uint8_t>(programHeaderSize);
+		unsigned long programUncompressedSize = programHeaderSize;
+		uncompress(&programSectionUncompressed[0], &programUncompressedSize, programSectionCompressed.data(), programCompressedSize);
+		programUncompressedSize = Get32BitsLE(&programSectionUncompressed[programSizeOffset]) + programHeaderSize;
+		this->programSection.resize(programUncompressedSize);
+		uncompress(&this->programSection[0], &programUncompressedSize, programSectionCompressed.data(), programCompressedSize);
 	}
 
-	if (xSF.tellg() != filesize && filesize >= reservedSize + programCompressedSize + 21)
+	if (filesize >= endOfProgram + 5 && !memcmp(&xSF[endOfProgram], "[TAG]", 5))
 	{
-		char tagheader[6] = "";
-		xSF.read(tagheader, 5);
-		if (std::string(tagheader) == "[TAG]")
+		auto rawtags = xSF.Subview(endOfProgram + 5, filesize - endOfProgram - 5);
+		std::string name, value;
+		bool onName = true;
+		for (auto curr : rawtags)
 		{
-			auto startOfTags = xSF.tellg();
-			unsigned lengthOfTags = static_cast<unsigned>(filesize - startOfTags);
-			if (lengthOfTags)
+			if (curr == 0x0A)
 			{
-				auto rawtags = std::vector<char>(lengthOfTags);
-				xSF.read(&rawtags[0], lengthOfTags);
-				std::string name, value;
-				bool onName = true;
-				for (unsigned x = 0; x < lengthOfTags; ++x)
+				if (!name.empty() && !value.empty())
 				{
-					char curr = rawtags[x];
-					if (curr == 0x0A)
-					{
-						if (!name.empty() && !value.empty())
-						{
-							name = TrimWhitespace(name);
-							value = TrimWhitespace(value);
-							if (this->tags.Exists(name))
-								this->tags[name] += "\n" + value;
-							else
-								this->tags[name] = value;
-						}
-						name = value = "";
-						onName = true;
-						continue;
-					}
-					if (curr == '=')
-					{
-						onName = false;
-						continue;
-					}
-					if (onName)
-						name += curr;
+					name = TrimWhitespace(name);
+					value = TrimWhitespace(value);
+					if (this->tags.Exists(name))
+						this->tags[name] += "\n" + value;
 					else
-						value += curr;
+						this->tags[name] = value;
 				}
+				name = value = "";
+				onName = true;
+				continue;
+			}
+			if (curr == '=')
+			{
+				onName = false;
+				continue;
 			}
+			if (onName)
+				name += static_cast<char>(curr);
+			else
+				value += static_cast<char>(curr);
 		}
 	}
 
 	this->hasFile = true;
 }
 
+ByteView XSFFile::GetRawData() const
+{
+	return this->rawData.empty() ? this->rawDataView : ByteView(this->rawData);
+}
+
+// Takes copies of anything still pointing into the mapping and then lets go of it, this is needed before the whole file is rewritten.
+void XSFFile::ReleaseMapping()
+{
+	if (!this->rawDataView.empty())
+	{
+		this->rawData = this->rawDataView.ToVector();
+		this->rawDataView = ByteView();
+	}
+	if (!this->reservedSectionView.empty())
+	{
+		this->reservedSection = this->reservedSectionView.ToVector();
+		this->reservedSectionView = ByteView();
+	}
+	this->virtualFile.reset();
+}
+
 bool XSFFile::IsValidType(uint8_t type) const
 {
 	return this->xSFType == type;
@@ -234,6 +211,10 @@ void XSFFile::Clear()
 {
 	this->xSFType = 0;
 	this->hasFile = false;
+	memset(this->header, 0, sizeof(this->header));
+	this->virtualFile.reset();
+	this->rawDataView = this->reservedSectionView = ByteView();
+	this->rawData.clear();
 	this->reservedSection.clear();
 	this->programSection.clear();
 	this->tags.Clear();
@@ -244,14 +225,20 @@ bool XSFFile::HasFile() const
 	return this->hasFile;
 }
 
+// The reserved section is only copied out of the mapping once something asks for a modifiable version of it.
 std::vector<uint8_t> &XSFFile::GetReservedSection()
 {
+	if (!this->reservedSectionView.empty())
+	{
+		this->reservedSection = this->reservedSectionView.ToVector();
+		this->reservedSectionView = ByteView();
+	}
 	return this->reservedSection;
 }
 
-std::vector<uint8_t> XSFFile::GetReservedSection() const
+ByteView XSFFile::GetReservedSection() const
 {
-	return this->reservedSection;
+	return this->reservedSection.empty() ? this->reservedSectionView : ByteView(this->reservedSection);
 }
 
 std::vector<uint8_t> &XSFFile::GetProgramSection()
@@ -259,7 +246,7 @@ std::vector<uint8_t> &XSFFile::GetProgramSection()
 	return this->programSection;
 }
 
-std::vector<uint8_t> XSFFile::GetProgramSection() const
+const std::vector<uint8_t> &XSFFile::GetProgramSection() const
 {
 	return this->programSection;
 }
@@ -284,22 +271,22 @@ void XSFFile::SetTag(const std::string &name, const std::wstring &value)
 	this->tags[name] = ConvertFuncs::WStringToString(value);
 }
 
-bool XSFFile::GetTagExists(const std::string &name) const
+bool XSFFile::GetTagExists(const TagKey &name) const
 {
 	return this->tags.Exists(name);
 }
 
-std::string XSFFile::GetTagValue(const std::string &name) const
+std::string_view XSFFile::GetTagValue(const TagKey &name) const
 {
-	return this->GetTagExists(name) ? this->tags[name] : "";
+	return this->tags[name];
 }
 
 unsigned long XSFFile::GetLengthMS(unsigned long defaultLength) const
 {
 	unsigned long length = 0;
-	std::string value = this->GetTagValue("length");
+	auto value = this->GetTagValue(WellKnownTags::Length);
 	if (!value.empty())
-		length = ConvertFuncs::StringToMS(value);
+		length = ConvertFuncs::StringToMS(std::string(value));
 	if (!length)
 		length = defaultLength;
 	return length;
@@ -308,9 +295,9 @@ unsigned long XSFFile::GetLengthMS(unsigned long defaultLength) const
 unsigned long XSFFile::GetFadeMS(unsigned long defaultFade) const
 {
 	unsigned long fade = defaultFade;
-	std::string value = this->GetTagValue("fade");
+	auto value = this->GetTagValue(WellKnownTags::Fade);
 	if (!value.empty())
-		fade = ConvertFuncs::StringToMS(value);
+		fade = ConvertFuncs::StringToMS(std::string(value));
 	return fade;
 }
 
@@ -318,137 +305,41 @@ double XSFFile::GetVolume(VolumeType preferredVolumeType, PeakType preferredPeak
 {
 	if (preferredVolumeType == VOLUMETYPE_NONE)
 		return 1.0;
-	std::string replaygain_album_gain = this->GetTagValue("replaygain_album_gain"), replaygain_album_peak = this->GetTagValue("replaygain_album_peak");
-	std::string replaygain_track_gain = this->GetTagValue("replaygain_track_gain"), replaygain_track_peak = this->GetTagValue("replaygain_track_peak");
-	std::string volume = this->GetTagValue("volume");
+	auto replaygain_album_gain = this->GetTagValue(WellKnownTags::ReplayGainAlbumGain), replaygain_album_peak = this->GetTagValue(WellKnownTags::ReplayGainAlbumPeak);
+	auto replaygain_track_gain = this->GetTagValue(WellKnownTags::ReplayGainTrackGain), replaygain_track_peak = this->GetTagValue(WellKnownTags::ReplayGainTrackPeak);
+	auto volume = this->GetTagValue(WellKnownTags::Volume);
 	double gain = 0.0;
 	bool hadReplayGain = false;
 	if (preferredVolumeType == VOLUMETYPE_REPLAYGAIN_ALBUM && !replaygain_album_gain.empty())
 	{
-		gain = convertTo<double>(replaygain_album_gain, false);
+		gain = convertTo<double>(std::string(replaygain_album_gain), false);
 		hadReplayGain = true;
 	}
 	if (!hadReplayGain && preferredVolumeType != VOLUMETYPE_VOLUME && !replaygain_track_gain.empty())
 	{
-		gain = convertTo<double>(replaygain_track_gain, false);
+		gain = convertTo<double>(std::string(replaygain_track_gain), false);
 		hadReplayGain = true;
 	}
 	if (hadReplayGain)
 	{
 		double vol = std::pow(10.0, gain / 20.0), peak = 1.0;
 		if (preferredPeakType == PEAKTYPE_REPLAYGAIN_ALBUM && !replaygain_album_peak.empty())
-			peak = convertTo<double>(replaygain_album_peak, false);
+			peak = convertTo<double>(std::string(replaygain_album_peak), false);
 		else if (preferredPeakType != PEAKTYPE_NONE && !replaygain_track_peak.empty())
-			peak = convertTo<double>(replaygain_track_peak, false);
+			peak = convertTo<double>(std::string(replaygain_track_peak), false);
 		return !fEqual(peak, 1.0) ? std::min(vol, 1.0 / peak) : vol;
 	}
-	return volume.empty() ? 1.0 : convertTo<double>(volume, false);
+	return volume.empty() ? 1.0 : convertTo<double>(std::string(volume), false);
 }
 
-std::string XSFFile::FormattedTitleOptionalBlock(const std::string &block, bool &hadReplacement, unsigned level) const
+std::string XSFFile::GetFormattedTitle(const std::string &format) const
 {
-	std::string formattedBlock;
-	for (size_t x = 0, len = block.length(); x < len; ++x)
-	{
-		char c = block[x];
-		if (c == '%')
-		{
-			size_t origX = x;
-			for (++x; x < len; ++x)
-				if (block[x] == '%')
-					break;
-			if (x != len)
-			{
-				std::string tagname = block.substr(origX + 1, x - origX - 1);
-				std::string value = this->GetTagValue(tagname);
-				if (!value.empty())
-				{
-					formattedBlock += value;
-					hadReplacement = true;
-				}
-			}
-			continue;
-		}
-		if (c == '[' && level + 1 < 10)
-		{
-			size_t origX = x;
-			unsigned nests = 0;
-			for (++x; x < len; ++x)
-			{
-				if (block[x] == '[')
-					++nests;
-				else if (block[x] == ']')
-				{
-					if (!nests)
-						break;
-					--nests;
-				}
-			}
-			if (x != len)
-			{
-				std::string innerBlock = block.substr(origX + 1, x - origX - 1);
-				bool hadInnerReplacement = false;
-				std::string replacedBlock = this->FormattedTitleOptionalBlock(innerBlock, hadInnerReplacement, level + 1);
-				if (hadInnerReplacement)
-					formattedBlock += replacedBlock;
-			}
-			continue;
-		}
-		formattedBlock += c;
-	}
-	return formattedBlock;
+	return this->GetFormattedTitle(TitleFormat(format));
 }
 
-std::string XSFFile::GetFormattedTitle(const std::string &format) const
+std::string XSFFile::GetFormattedTitle(const TitleFormat &format) const
 {
-	std::string formattedTitle;
-	for (size_t x = 0, len = format.length(); x < len; ++x)
-	{
-		char c = format[x];
-		if (c == '%')
-		{
-			size_t origX = x;
-			for (++x; x < len; ++x)
-				if (format[x] == '%')
-					break;
-			if (x != len)
-			{
-				std::string tagname = format.substr(origX + 1, x - origX - 1);
-				std::string value = this->GetTagValue(tagname);
-				if (value.empty())
-					formattedTitle += "???";
-				else
-					formattedTitle += value;
-			}
-		}
-		else if (c == '[')
-		{
-			size_t origX = x;
-			unsigned nests = 0;
-			for (++x; x < len; ++x)
-			{
-				if (format[x] == '[')
-					++nests;
-				else if (format[x] == ']')
-				{
-					if (!nests)
-						break;
-					--nests;
-				}
-			}
-			if (x != len)
-			{
-				std::string block = format.substr(origX + 1, x - origX - 1);
-				bool hadReplacement = false;
-				std::string replacedBlock = this->FormattedTitleOptionalBlock(block, hadReplacement, 1);
-				if (hadReplacement)
-					formattedTitle += replacedBlock;
-			}
-		}
-		else
-			formattedTitle += c;
-	}
-	return formattedTitle;
+	return format.Format(this->tags);
 }
 
 std::string XSFFile::GetFilename() const
@@ -461,30 +352,151 @@ std::string XSFFile::GetFilenameWithoutPath() const
 	return ExtractFilenameFromPath(this->fileName);
 }
 
-void XSFFile::SaveFile() const
+std::string XSFFile::GetTagBlock() const
 {
-#if defined(_WIN32) && !defined(_MSC_VER)
-	ofstream_wfopen xSF;
+	std::string tagBlock;
+	auto allTags = this->tags.GetTags();
+	if (!allTags.empty())
+	{
+		tagBlock = "[TAG]";
+		std::for_each(allTags.begin(), allTags.end(), [&](const std::string &tag)
+		{
+			tagBlock += tag;
+			tagBlock += '\n';
+		});
+	}
+	return tagBlock;
+}
+
+static FILE *OpenFile(const std::string &filename, const wchar_t *wmode, const char *mode)
+{
+#ifdef _WIN32
+	static_cast<void>(mode);
+	return _wfopen(ConvertFuncs::StringToWString(filename).c_str(), wmode);
+#else
+	static_cast<void>(wmode);
+	return fopen(filename.c_str(), mode);
+#endif
+}
+
+static bool TruncateFile(FILE *file, long size)
+{
+	if (fflush(file))
+		return false;
+#ifdef _WIN32
+	return !_chsize_s(_fileno(file), size);
 #else
-	std::ofstream xSF;
+	return !ftruncate(fileno(file), size);
 #endif
-	xSF.exceptions(std::ofstream::failbit);
+}
+
+static bool ReplaceFileWith(const std::string &source, const std::string &destination)
+{
 #ifdef _WIN32
-	xSF.open(ConvertFuncs::StringToWString(this->fileName).c_str(), std::ofstream::out | std::ofstream::binary);
+	return !!MoveFileExW(ConvertFuncs::StringToWString(source).c_str(), ConvertFuncs::StringToWString(destination).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
 #else
-	xSF.open(this->fileName.c_str(), std::ofstream::out | std::ofstream::binary);
+	return !rename(source.c_str(), destination.c_str());
 #endif
+}
 
-	xSF.write(reinterpret_cast<const char *>(&this->rawData[0]), this->rawData.size());
+// Replaces only what comes after the program section, leaving the header, reserved section and program section on disk untouched.
+// This is only done if the file on disk still has the same header as when it was read and is at least as long as that header says it should be.
+// Returns false if the whole file needs to be written instead.
+bool XSFFile::UpdateTagsInPlace(const std::string &tagBlock)
+{
+	auto rawDataOnDisk = this->GetRawData();
+	if (rawDataOnDisk.size() < 16)
+		return false;
 
-	auto allTags = this->tags.GetTags();
-	if (!allTags.empty())
+	FILE *xSF = OpenFile(this->fileName, L"r+b", "r+b");
+	if (!xSF)
+		return false;
+
+	uint8_t headerOnDisk[16];
+	long fileSize = 0, rawDataSize = static_cast<long>(rawDataOnDisk.size()), newFileSize = rawDataSize + static_cast<long>(tagBlock.length());
+	if (fread(headerOnDisk, 1, 16, xSF) != 16 || memcmp(headerOnDisk, this->header, 16) || fseek(xSF, 0, SEEK_END) || (fileSize = ftell(xSF)) < rawDataSize)
 	{
-		xSF.write("[TAG]", 5);
-		std::for_each(allTags.begin(), allTags.end(), [&](const std::string &tag)
+		fclose(xSF);
+		// If the file was changed in place, a mapping of it will have changed along with it, so there is nothing reliable left to write
+		if (this->rawData.empty())
+			throw std::runtime_error("File " + this->fileName + " has changed since it was read.");
+		return false;
+	}
+
+	// Windows will not truncate a file that is mapped, so when the tags shrink our own mapping is swapped for copies of what it covered.
+	// The mapping is only taken back once the file has been remapped, the copies stay in use if that fails.
+	bool truncate = newFileSize < fileSize;
+	bool hadMapping = truncate && !!this->virtualFile;
+	if (hadMapping)
+		this->ReleaseMapping();
+
+	// A failure part way through leaves the tags half-written, the false return then has the whole file rewritten instead
+	bool success = true;
+	if (truncate)
+		success = TruncateFile(xSF, newFileSize);
+	if (success && !tagBlock.empty())
+		success = !fseek(xSF, rawDataSize, SEEK_SET) && fwrite(tagBlock.c_str(), 1, tagBlock.length(), xSF) == tagBlock.length();
+	success = !fclose(xSF) && success;
+
+	if (hadMapping && success)
+	{
+		try
 		{
-			xSF.write(tag.c_str(), tag.length());
-			xSF.write("\n", 1);
-		});
+			auto remapped = VirtualFile::Open(this->fileName);
+			ByteView remappedRawData = remapped->GetView(0, rawDataSize), remappedReservedSection;
+			if (!this->reservedSection.empty())
+				remappedReservedSection = remapped->GetView(16, this->reservedSection.size());
+			this->virtualFile = remapped;
+			this->rawDataView = remappedRawData;
+			this->reservedSectionView = remappedReservedSection;
+			this->rawData.clear();
+			this->reservedSection.clear();
+		}
+		catch (const std::exception &)
+		{
+		}
+	}
+
+	return success;
+}
+
+// Writes the entire file to a temporary file first and then replaces the original with it, so the original is never left half-written.
+void XSFFile::RewriteFile(const std::string &tagBlock)
+{
+	this->ReleaseMapping();
+
+	auto rawDataToWrite = this->GetRawData();
+	// The temporary file is created exclusively, so an existing file that happens to have the same name is never overwritten
+	std::string tempFileName;
+	FILE *xSF = nullptr;
+	for (unsigned attempt = 0; attempt < 100; ++attempt)
+	{
+		tempFileName = this->fileName + ".tmp" + (attempt ? stringify(attempt) : "");
+		xSF = OpenFile(tempFileName, L"wbx", "wbx");
+		if (xSF || errno != EEXIST)
+			break;
+	}
+	if (!xSF)
+		throw std::runtime_error("Unable to open a temporary file for writing " + this->fileName + ".");
+
+	bool success = fwrite(rawDataToWrite.data(), 1, rawDataToWrite.size(), xSF) == rawDataToWrite.size();
+	if (success && !tagBlock.empty())
+		success = fwrite(tagBlock.c_str(), 1, tagBlock.length(), xSF) == tagBlock.length();
+	success = !fclose(xSF) && success;
+	if (!success || !ReplaceFileWith(tempFileName, this->fileName))
+	{
+		remove(tempFileName.c_str());
+		throw std::runtime_error("Unable to save file " + this->fileName + ".");
 	}
 }
+
+// Saving only rewrites the tags at the end of the file when possible, the whole file is only written if the file has changed since it was read.
+void XSFFile::SaveFile()
+{
+	if (VirtualFile::IsArchiveMember(this->fileName))
+		throw std::runtime_error("Unable to save file " + this->fileName + ", files within zip archives cannot be saved.");
+
+	auto tagBlock = this->GetTagBlock();
+	if (!this->UpdateTagsInPlace(tagBlock))
+		this->RewriteFile(tagBlock);
+}
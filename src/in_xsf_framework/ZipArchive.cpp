@@ -0,0 +1,175 @@
+/*
+ * xSF - Zip archives
+ * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
+ * Last modification on 2026-10-19
+ *
+ * Read-only access to the members of a zip archive, specifications found at
+ * https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+ */
+
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+#include "ZipArchive.h"
+#include "XSFCommon.h"
+
+static const uint32_t LocalHeaderSignature = 0x04034B50;
+static const uint32_t CentralHeaderSignature = 0x02014B50;
+static const uint32_t EndOfCentralDirectorySignature = 0x06054B50;
+static const size_t LocalHeaderSize = 30;
+static const size_t CentralHeaderSize = 46;
+static const size_t EndOfCentralDirectorySize = 22;
+static const uint16_t MethodStored = 0;
+static const uint16_t MethodDeflated = 8;
+
+static inline uint16_t Get16BitsLE(const uint8_t *input)
+{
+	return input[0] | (input[1] << 8);
+}
+
+// A stored member is a view straight into the archive's mapping, while a deflated member is inflated into memory once when it is
+// opened. Either way the member keeps its archive alive, so the rest of a set is opened from the same archive while any of its
+// files are still open.
+class ZipArchiveMember : public VirtualFile
+{
+	std::shared_ptr<const ZipArchive> archive;
+	ByteView view;
+	std::vector<uint8_t> inflated;
+public:
+	ZipArchiveMember(const std::shared_ptr<const ZipArchive> &zipArchive, const ByteView &data) : archive(zipArchive), view(data), inflated() { }
+	ZipArchiveMember(const std::shared_ptr<const ZipArchive> &zipArchive, std::vector<uint8_t> &&data) : archive(zipArchive), view(), inflated(std::move(data))
+	{
+		this->view = ByteView(this->inflated);
+	}
+
+	ByteView GetView() const override { return this->view; }
+};
+
+ZipArchive::ZipArchive(const std::string &filename) : file(new MappedFile(filename)), fileName(filename), entries()
+{
+	this->ReadCentralDirectory();
+}
+
+void ZipArchive::ReadCentralDirectory()
+{
+	auto zip = this->file->GetView();
+	if (zip.size() < EndOfCentralDirectorySize)
+		throw std::runtime_error("File " + this->fileName + " is not a zip archive.");
+
+	// The end of central directory record is at the very end of the file unless the archive has a comment, which can be up to 64 KiB long
+	size_t lowestEnd = zip.size() > EndOfCentralDirectorySize + 0xFFFF ? zip.size() - EndOfCentralDirectorySize - 0xFFFF : 0;
+	size_t end = zip.size() - EndOfCentralDirectorySize + 1;
+	do
+	{
+		--end;
+		if (Get32BitsLE(&zip[end]) == EndOfCentralDirectorySignature)
+			break;
+	} while (end > lowestEnd);
+	if (Get32BitsLE(&zip[end]) != EndOfCentralDirectorySignature)
+		throw std::runtime_error("File " + this->fileName + " is not a zip archive.");
+
+	uint16_t entryCount = Get16BitsLE(&zip[end + 10]);
+	uint32_t directorySize = Get32BitsLE(&zip[end + 12]), directoryOffset = Get32BitsLE(&zip[end + 16]);
+	if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF)
+		throw std::runtime_error("Zip archive " + this->fileName + " is a Zip64 archive, which is not supported.");
+
+	auto directory = zip.Subview(directoryOffset, directorySize);
+	size_t pos = 0;
+	for (uint16_t i = 0; i < entryCount; ++i)
+	{
+		auto header = directory.Subview(pos, CentralHeaderSize);
+		if (Get32BitsLE(&header[0]) != CentralHeaderSignature)
+			throw std::runtime_error("Zip archive " + this->fileName + " has a corrupt central directory.");
+		uint16_t flags = Get16BitsLE(&header[8]);
+		uint16_t nameLength = Get16BitsLE(&header[28]), extraLength = Get16BitsLE(&header[30]), commentLength = Get16BitsLE(&header[32]);
+		auto name = directory.Subview(pos + CentralHeaderSize, nameLength);
+		pos += CentralHeaderSize + nameLength + extraLength + commentLength;
+
+		// Directories and encrypted members are left out entirely
+		if (name.empty() || name[name.size() - 1] == '/' || (flags & 0x0001))
+			continue;
+
+		Entry entry = { Get16BitsLE(&header[10]), Get32BitsLE(&header[16]), Get32BitsLE(&header[20]), Get32BitsLE(&header[24]), Get32BitsLE(&header[42]) };
+		this->entries[ZipArchive::NormalizeMemberName(std::string(name.begin(), name.end()))] = entry;
+	}
+}
+
+std::string ZipArchive::NormalizeMemberName(const std::string &name)
+{
+	std::vector<std::string> parts;
+	size_t start = 0;
+	while (start <= name.length())
+	{
+		size_t sep = name.find_first_of("\\/", start);
+		if (sep == std::string::npos)
+			sep = name.length();
+		auto part = name.substr(start, sep - start);
+		// A .. at the root of the archive has nowhere to go, so it is dropped the same as it would be at the root of a drive
+		if (part == "..")
+		{
+			if (!parts.empty())
+				parts.pop_back();
+		}
+		else if (!part.empty() && part != ".")
+			parts.push_back(part);
+		start = sep + 1;
+	}
+
+	std::string normalized;
+	for (auto curr = parts.begin(), end = parts.end(); curr != end; ++curr)
+	{
+		if (!normalized.empty())
+			normalized += '/';
+		normalized += *curr;
+	}
+	return normalized;
+}
+
+std::shared_ptr<const VirtualFile> ZipArchive::OpenMember(const std::string &name) const
+{
+	auto entry = this->entries.find(ZipArchive::NormalizeMemberName(name));
+	if (entry == this->entries.end())
+		throw std::logic_error("File " + name + " does not exist within zip archive " + this->fileName + ".");
+
+	auto zip = this->file->GetView();
+	auto &info = entry->second;
+	auto localHeader = zip.Subview(info.localHeaderOffset, LocalHeaderSize);
+	if (Get32BitsLE(&localHeader[0]) != LocalHeaderSignature)
+		throw std::runtime_error("Zip archive " + this->fileName + " has a corrupt header for " + name + ".");
+	// The sizes in the local header can be left as 0 when the member was streamed into the archive, so the central directory's are used
+	size_t dataOffset = info.localHeaderOffset + LocalHeaderSize + Get16BitsLE(&localHeader[26]) + Get16BitsLE(&localHeader[28]);
+	auto compressed = zip.Subview(dataOffset, info.compressedSize);
+
+	std::shared_ptr<const VirtualFile> member;
+	if (info.method == MethodStored)
+	{
+		if (info.compressedSize != info.uncompressedSize)
+			throw std::runtime_error("Zip archive " + this->fileName + " has a corrupt header for " + name + ".");
+		member.reset(new ZipArchiveMember(this->shared_from_this(), compressed));
+	}
+	else if (info.method == MethodDeflated)
+	{
+		std::vector<uint8_t> inflated(info.uncompressedSize);
+		z_stream stream = z_stream();
+		// A negative window size tells zlib to expect raw deflate data, without the zlib header and checksum
+		if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+			throw std::runtime_error("Unable to initialize zlib to read " + name + ".");
+		stream.next_in = const_cast<Bytef *>(compressed.data());
+		stream.avail_in = info.compressedSize;
+		stream.next_out = inflated.empty() ? nullptr : &inflated[0];
+		stream.avail_out = info.uncompressedSize;
+		int result = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+		if (result != Z_STREAM_END || stream.total_out != info.uncompressedSize)
+			throw std::runtime_error("Unable to decompress " + name + " from zip archive " + this->fileName + ".");
+		member.reset(new ZipArchiveMember(this->shared_from_this(), std::move(inflated)));
+	}
+	else
+		throw std::runtime_error("File " + name + " within zip archive " + this->fileName + " uses an unsupported compression method.");
+
+	auto data = member->GetView();
+	if (crc32(crc32(0, Z_NULL, 0), data.data(), static_cast<uInt>(data.size())) != info.crc)
+		throw std::runtime_error("File " + name + " within zip archive " + this->fileName + " failed its CRC check.");
+
+	return member;
+}
@@ -1,7 +1,7 @@
 /*
  * xSF - Winamp plugin
  * By Naram Qashat (CyberBotX) [cyberbotx@cyberbotx.com]
- * Last modification on 2014-10-05
+ * Last modification on 2026-10-19
  *
  * Partially based on the vio*sf framework
  */
@@ -9,6 +9,7 @@
 #include "XSFPlayer.h"
 #include "XSFConfig.h"
 #include "XSFCommon.h"
+#include "eqstr.h"
 #include "windowsh_wrapper.h"
 #include <winamp/in2.h>
 #include <winamp/wa_ipc.h>
@@ -125,7 +126,7 @@ void getFileInfo(const in_char *file, in_char *title, int *length_in_ms)
 		toFree = true;
 	}
 	if (title)
-		CopyToString(xSF->GetFormattedTitle(xSFConfig->GetTitleFormat()).substr(0, GETFILEINFO_TITLE_LENGTH - 1), title);
+		CopyToString(xSF->GetFormattedTitle(xSFConfig->GetCompiledTitleFormat()).substr(0, GETFILEINFO_TITLE_LENGTH - 1), title);
 	if (length_in_ms)
 		*length_in_ms = xSF->GetLengthMS(xSFConfig->GetDefaultLength()) + xSF->GetFadeMS(xSFConfig->GetDefaultFade());
 	if (toFree)